@@ -1,2 +1,4 @@
 TEMPLATE = subdirs
-SUBDIRS += src
+SUBDIRS += src tests
+
+tests.depends = src
@@ -0,0 +1,130 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "glcontext.h"
+#include "logging.h"
+#include "window.h"
+
+#include "../../../ubuntumirclient/qmirclientframetimings.h"
+#include "../../../ubuntumirclient/qmirclientstartuptrace.h"
+
+#include <QtPlatformSupport/private/qeglpbuffer_p.h>
+
+#include <time.h>
+
+QUbuntuOpenGLContext::QUbuntuOpenGLContext(const QSurfaceFormat &format, QPlatformOpenGLContext *share,
+                                           EGLDisplay display, EGLConfig config, bool surfaceless,
+                                           qreal frameRate)
+    : QEGLPlatformContext(format, share, display, &config)
+    , mSurfaceless(surfaceless)
+    , mFrameInterval(frameRate > 0 ? static_cast<qint64>(1e9 / frameRate) : 0)
+{
+    mClock.start();
+}
+
+bool QUbuntuOpenGLContext::makeCurrent(QPlatformSurface *surface)
+{
+    const bool ret = QEGLPlatformContext::makeCurrent(surface);
+
+    // makeCurrent may be called several times for a single frame
+    if (ret && surface->surface()->surfaceClass() == QSurface::Window) {
+        auto window = static_cast<QUbuntuWindow *>(surface);
+        if (window->frameStart < 0) {
+            window->frameStart = mClock.nsecsElapsed();
+        }
+    }
+    return ret;
+}
+
+// Following method used internally in the base class QEGLPlatformContext to access
+// the egl surface of a QPlatformSurface/QUbuntuWindow
+EGLSurface QUbuntuOpenGLContext::eglSurfaceForPlatformSurface(QPlatformSurface *surface)
+{
+    if (surface->surface()->surfaceClass() == QSurface::Window) {
+        return static_cast<QUbuntuWindow *>(surface)->eglSurface(eglConfig());
+    } else if (mSurfaceless) {
+        return EGL_NO_SURFACE;
+    } else {
+        return static_cast<QEGLPbuffer *>(surface)->pbuffer();
+    }
+}
+
+void QUbuntuOpenGLContext::swapBuffers(QPlatformSurface *surface)
+{
+    if (surface->surface()->surfaceClass() != QSurface::Window) {
+        if (!mSurfaceless) {
+            QEGLPlatformContext::swapBuffers(surface);
+        }
+        return;
+    }
+
+    auto window = static_cast<QUbuntuWindow *>(surface);
+    const qint64 swapStart = mClock.nsecsElapsed();
+    QEGLPlatformContext::swapBuffers(surface);
+    QMirClientStartupTrace::firstFrameSwapped();
+    waitForNextFrame();
+    const qint64 swapEnd = mClock.nsecsElapsed();
+
+    if (window->frameStart >= 0) {
+        const quint64 frameNumber = window->frameTimings()->addFrame(swapStart - window->frameStart,
+                                                                     swapEnd - swapStart);
+        qCDebug(ubuntu, "frameTiming(window=%p) [%llu] - cpu %lldus, swap %lldus", window->window(),
+                frameNumber, (swapStart - window->frameStart) / 1000, (swapEnd - swapStart) / 1000);
+        window->frameStart = -1;
+    }
+}
+
+void QUbuntuOpenGLContext::waitForNextFrame()
+{
+    if (mFrameInterval == 0) {
+        return;
+    }
+
+    // Like a display, tick at a fixed rate and skip the ticks a late frame missed
+    const qint64 now = mClock.nsecsElapsed();
+    if (mNextFrame <= now) {
+        mNextFrame = now + mFrameInterval - (now - mNextFrame) % mFrameInterval;
+    }
+
+    const qint64 delay = mNextFrame - now;
+    const struct timespec request = { static_cast<time_t>(delay / 1000000000), static_cast<long>(delay % 1000000000) };
+    nanosleep(&request, nullptr);
+    mNextFrame += mFrameInterval;
+}
@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QUBUNTUGLCONTEXT_H
+#define QUBUNTUGLCONTEXT_H
+
+#include <qpa/qplatformoffscreensurface.h>
+#include <QOffscreenSurface>
+#include <QtPlatformSupport/private/qeglplatformcontext_p.h>
+#include <QElapsedTimer>
+
+#include <EGL/egl.h>
+
+/*
+ * QUbuntuOpenGLContext - EGL context of the headless platform.
+ *
+ * Windows are rendered into pbuffers. As swapping those never blocks, swapBuffers() waits for
+ * the next tick of the screen's frame rate to keep the render loops paced as on a real display.
+ * The frame times of every window are recorded like ubuntumirclient does, without GPU times.
+ */
+class QUbuntuOpenGLContext : public QEGLPlatformContext
+{
+public:
+    QUbuntuOpenGLContext(const QSurfaceFormat &format, QPlatformOpenGLContext *share,
+                         EGLDisplay display, EGLConfig config, bool surfaceless, qreal frameRate);
+
+    // QEGLPlatformContext methods.
+    void swapBuffers(QPlatformSurface *surface) final;
+    bool makeCurrent(QPlatformSurface *surface) final;
+
+protected:
+    EGLSurface eglSurfaceForPlatformSurface(QPlatformSurface *surface) final;
+
+private:
+    void waitForNextFrame();
+
+    const bool mSurfaceless;
+    const qint64 mFrameInterval; // ns, 0 if not throttled
+    QElapsedTimer mClock;
+    qint64 mNextFrame{0};
+};
+
+/*
+ * QUbuntuOffscreenSurface - offscreen surface made current with EGL_NO_SURFACE, for EGL
+ * implementations supporting EGL_KHR_surfaceless_context.
+ */
+class QUbuntuOffscreenSurface : public QPlatformOffscreenSurface
+{
+public:
+    QUbuntuOffscreenSurface(QOffscreenSurface *offscreenSurface)
+        : QPlatformOffscreenSurface(offscreenSurface) {}
+
+    // QPlatformOffscreenSurface methods.
+    QSurfaceFormat format() const override { return offscreenSurface()->requestedFormat(); }
+    bool isValid() const override { return true; }
+};
+
+#endif // QUBUNTUGLCONTEXT_H
@@ -0,0 +1,254 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "input.h"
+#include "logging.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QGuiApplication>
+#include <QKeySequence>
+#include <QScreen>
+#include <QTouchDevice>
+#include <QWindow>
+
+namespace {
+
+const int touchPointSize = 8;
+
+} // anonymous namespace
+
+QUbuntuInput::QUbuntuInput()
+    : mNext(0)
+    , mStarted(false)
+    , mTouchDevice(nullptr)
+{
+    mTimer.setSingleShot(true);
+    connect(&mTimer, &QTimer::timeout, this, &QUbuntuInput::replay);
+
+    const QString path = QFile::decodeName(qgetenv("QTUBUNTU_HEADLESS_INPUT"));
+    if (path.isEmpty() || !load(path)) {
+        return;
+    }
+
+    mTouchDevice = new QTouchDevice;
+    mTouchDevice->setType(QTouchDevice::TouchScreen);
+    mTouchDevice->setCapabilities(QTouchDevice::Position | QTouchDevice::Area | QTouchDevice::Pressure
+                                  | QTouchDevice::NormalizedPosition);
+    QWindowSystemInterface::registerTouchDevice(mTouchDevice);
+}
+
+QUbuntuInput::~QUbuntuInput()
+{
+    // Qt will take care of deleting mTouchDevice.
+}
+
+bool QUbuntuInput::load(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qCWarning(ubuntuInput) << "Unable to open input script" << path << file.errorString();
+        return false;
+    }
+
+    int lineNumber = 0;
+    while (!file.atEnd()) {
+        ++lineNumber;
+        QString line = QString::fromUtf8(file.readLine());
+        const int commentStart = line.indexOf(QLatin1Char('#'));
+        if (commentStart >= 0) {
+            line.truncate(commentStart);
+        }
+        const QStringList words = line.simplified().split(QLatin1Char(' '), QString::SkipEmptyParts);
+        if (words.isEmpty()) {
+            continue;
+        }
+
+        Command command{Wait, 0, 0, 0, Qt::NoModifier, QString()};
+        bool ok = true;
+        const QString &verb = words.at(0);
+        if (verb == QLatin1String("wait") && words.size() == 2) {
+            command.x = words.at(1).toInt(&ok);
+        } else if ((verb == QLatin1String("touch") || verb == QLatin1String("mouse")) && words.size() == 4) {
+            const bool touch = verb == QLatin1String("touch");
+            if (words.at(1) == QLatin1String("press")) {
+                command.action = touch ? TouchPress : MousePress;
+            } else if (words.at(1) == QLatin1String("move")) {
+                command.action = touch ? TouchMove : MouseMove;
+            } else if (words.at(1) == QLatin1String("release")) {
+                command.action = touch ? TouchRelease : MouseRelease;
+            } else {
+                ok = false;
+            }
+            bool xOk, yOk;
+            command.x = words.at(2).toInt(&xOk);
+            command.y = words.at(3).toInt(&yOk);
+            ok = ok && xOk && yOk;
+        } else if (verb == QLatin1String("key") && words.size() >= 3) {
+            if (words.at(1) == QLatin1String("press")) {
+                command.action = KeyPress;
+            } else if (words.at(1) == QLatin1String("release")) {
+                command.action = KeyRelease;
+            } else if (words.at(1) == QLatin1String("click")) {
+                command.action = KeyClick;
+            } else {
+                ok = false;
+            }
+            const QKeySequence sequence(words.at(2));
+            ok = ok && sequence.count() == 1;
+            if (ok) {
+                command.key = sequence[0] & ~Qt::KeyboardModifierMask;
+                command.modifiers = Qt::KeyboardModifiers(QFlag(sequence[0] & Qt::KeyboardModifierMask));
+                command.text = words.mid(3).join(QLatin1Char(' '));
+            }
+        } else if (verb == QLatin1String("quit") && words.size() == 1) {
+            command.action = Quit;
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            qCWarning(ubuntuInput) << "Ignoring input script" << path << "due to an error on line" << lineNumber;
+            mCommands.clear();
+            return false;
+        }
+        mCommands.append(command);
+    }
+
+    qCDebug(ubuntuInput) << "Loaded" << mCommands.size() << "input commands from" << path;
+    return !mCommands.isEmpty();
+}
+
+void QUbuntuInput::start()
+{
+    if (mStarted || mCommands.isEmpty()) {
+        return;
+    }
+    mStarted = true;
+    mClock.start();
+
+    // Let the window get exposed and render before the first event arrives
+    mTimer.start(0);
+}
+
+void QUbuntuInput::replay()
+{
+    while (mNext < mCommands.size()) {
+        const Command &command = mCommands.at(mNext++);
+        if (command.action == Wait) {
+            mTimer.start(command.x);
+            return;
+        }
+        dispatch(command);
+    }
+}
+
+void QUbuntuInput::dispatch(const Command &command)
+{
+    const QPoint globalPos(command.x, command.y);
+
+    switch (command.action) {
+    case TouchPress:
+    case TouchMove:
+    case TouchRelease: {
+        QWindow *window = QGuiApplication::topLevelAt(globalPos);
+        if (!window) {
+            qCDebug(ubuntuInput, "No window at %d,%d to touch", command.x, command.y);
+            return;
+        }
+        const QSize screenSize = window->screen()->size();
+
+        QWindowSystemInterface::TouchPoint touchPoint;
+        touchPoint.id = 0;
+        touchPoint.area = QRectF(globalPos.x() - touchPointSize / 2, globalPos.y() - touchPointSize / 2,
+                                 touchPointSize, touchPointSize);
+        touchPoint.normalPosition = QPointF(globalPos.x() / qreal(screenSize.width()),
+                                            globalPos.y() / qreal(screenSize.height()));
+        touchPoint.pressure = command.action == TouchRelease ? 0.0 : 1.0;
+        touchPoint.state = command.action == TouchPress ? Qt::TouchPointPressed
+                         : command.action == TouchMove ? Qt::TouchPointMoved
+                         : Qt::TouchPointReleased;
+
+        QList<QWindowSystemInterface::TouchPoint> touchPoints;
+        touchPoints.append(touchPoint);
+        QWindowSystemInterface::handleTouchEvent(window, mClock.elapsed(), mTouchDevice, touchPoints);
+        break;
+    }
+    case MousePress:
+    case MouseMove:
+    case MouseRelease: {
+        QWindow *window = QGuiApplication::topLevelAt(globalPos);
+        if (!window) {
+            qCDebug(ubuntuInput, "No window at %d,%d to click", command.x, command.y);
+            return;
+        }
+        const Qt::MouseButtons buttons = command.action == MouseRelease ? Qt::NoButton : Qt::LeftButton;
+        QWindowSystemInterface::handleMouseEvent(window, mClock.elapsed(), globalPos - window->geometry().topLeft(),
+                                                 globalPos, buttons);
+        break;
+    }
+    case KeyPress:
+        sendKey(QEvent::KeyPress, command);
+        break;
+    case KeyRelease:
+        sendKey(QEvent::KeyRelease, command);
+        break;
+    case KeyClick:
+        sendKey(QEvent::KeyPress, command);
+        sendKey(QEvent::KeyRelease, command);
+        break;
+    case Quit:
+        QCoreApplication::quit();
+        break;
+    case Wait:
+        break;
+    }
+}
+
+void QUbuntuInput::sendKey(QEvent::Type type, const Command &command)
+{
+    QWindow *window = QGuiApplication::focusWindow();
+    if (!window) {
+        qCDebug(ubuntuInput, "No focus window to send key 0x%x to", command.key);
+        return;
+    }
+    QWindowSystemInterface::handleKeyEvent(window, mClock.elapsed(), type, command.key, command.modifiers,
+                                           command.text);
+}
@@ -0,0 +1,103 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QUBUNTUINPUT_H
+#define QUBUNTUINPUT_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include <qpa/qwindowsysteminterface.h>
+
+class QTouchDevice;
+
+/*
+ * QUbuntuInput - replays a script of synthetic input events on the headless platform.
+ *
+ * The script is read from the file named by QTUBUNTU_HEADLESS_INPUT and started once the first
+ * window got created. One command per line, '#' starts a comment:
+ *
+ *   wait <milliseconds>
+ *   touch press|move|release <x> <y>
+ *   mouse press|move|release <x> <y>
+ *   key press|release|click <key> [<text>]     (key as in QKeySequence, e.g. "Return" or "Ctrl+A")
+ *   quit
+ *
+ * Coordinates are global. Pointer events go to the window under them, key events to the
+ * focus window.
+ */
+class QUbuntuInput : public QObject
+{
+    Q_OBJECT
+public:
+    QUbuntuInput();
+    virtual ~QUbuntuInput();
+
+    void start();
+
+private Q_SLOTS:
+    void replay();
+
+private:
+    enum Action { Wait, TouchPress, TouchMove, TouchRelease, MousePress, MouseMove, MouseRelease,
+                  KeyPress, KeyRelease, KeyClick, Quit };
+    struct Command {
+        Action action;
+        int x;
+        int y;
+        int key;
+        Qt::KeyboardModifiers modifiers;
+        QString text;
+    };
+
+    bool load(const QString &path);
+    void dispatch(const Command &command);
+    void sendKey(QEvent::Type type, const Command &command);
+
+    QVector<Command> mCommands;
+    int mNext;
+    bool mStarted;
+    QTimer mTimer;
+    QElapsedTimer mClock;
+    QTouchDevice *mTouchDevice;
+};
+
+#endif // QUBUNTUINPUT_H
@@ -0,0 +1,184 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "integration.h"
+#include "glcontext.h"
+#include "input.h"
+#include "logging.h"
+#include "nativeinterface.h"
+#include "screen.h"
+#include "window.h"
+
+#include "../../../ubuntumirclient/qmirclientbackingstore.h"
+#include "../../../ubuntumirclient/qmirclientextensions.h"
+#include "../../../ubuntumirclient/qmirclientprogrambinarycache.h"
+#include "../../../ubuntumirclient/qmirclientstartuptrace.h"
+
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QtPlatformSupport/private/qeglconvenience_p.h>
+#include <QtPlatformSupport/private/qeglpbuffer_p.h>
+#include <QtPlatformSupport/private/qgenericunixeventdispatcher_p.h>
+#include <QtPlatformSupport/private/qgenericunixfontdatabase_p.h>
+
+#include <EGL/eglext.h>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+QUbuntuIntegration::QUbuntuIntegration()
+    : mNativeInterface(new QUbuntuNativeInterface(this))
+    , mFontDb(new QGenericUnixFontDatabase)
+    , mProgramBinaryCache(new QMirClientProgramBinaryCache)
+    , mScreen(nullptr)
+    , mEglDisplay(EGL_NO_DISPLAY)
+    , mSurfaceless(false)
+{
+    QMirClientStartupTrace::Phase tracePhase("QUbuntuIntegration");
+    initializeEgl();
+}
+
+QUbuntuIntegration::~QUbuntuIntegration()
+{
+    QMirClientStartupTrace::finish();
+    if (mScreen) {
+        destroyScreen(mScreen);
+    }
+    if (mEglDisplay != EGL_NO_DISPLAY) {
+        eglTerminate(mEglDisplay);
+    }
+}
+
+void QUbuntuIntegration::initializeEgl()
+{
+    QMirClientStartupTrace::Phase tracePhase("eglInitialize");
+
+    // The surfaceless platform needs neither a display server nor a GPU device node to render
+    const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (qmirclientHasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")
+            && qmirclientHasExtension(clientExtensions, "EGL_EXT_platform_base")) {
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+                eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay) {
+            mEglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+    }
+    if (mEglDisplay == EGL_NO_DISPLAY) {
+        mEglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    if (mEglDisplay == EGL_NO_DISPLAY || !eglInitialize(mEglDisplay, nullptr, nullptr)) {
+        qCWarning(ubuntu, "Could not initialize EGL (error 0x%x)", eglGetError());
+        mEglDisplay = EGL_NO_DISPLAY;
+        return;
+    }
+
+    mSurfaceless = qmirclientHasExtension(eglQueryString(mEglDisplay, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+    qCDebug(ubuntu, "EGL %s by %s, surfaceless contexts %ssupported", eglQueryString(mEglDisplay, EGL_VERSION),
+            eglQueryString(mEglDisplay, EGL_VENDOR), mSurfaceless ? "" : "not ");
+}
+
+void QUbuntuIntegration::initialize()
+{
+    QMirClientStartupTrace::Phase tracePhase("initialize");
+    mScreen = new QUbuntuScreen;
+    screenAdded(mScreen);
+
+    mInput.reset(new QUbuntuInput);
+}
+
+bool QUbuntuIntegration::hasCapability(QPlatformIntegration::Capability cap) const
+{
+    switch (cap) {
+    case ThreadedOpenGL:
+    case ThreadedPixmaps:
+    case OpenGL:
+    case MultipleWindows:
+    case NonFullScreenWindows:
+    case RasterGLSurface:
+        return true;
+    default:
+        return QPlatformIntegration::hasCapability(cap);
+    }
+}
+
+QAbstractEventDispatcher *QUbuntuIntegration::createEventDispatcher() const
+{
+    return createUnixEventDispatcher();
+}
+
+QPlatformNativeInterface* QUbuntuIntegration::nativeInterface() const
+{
+    return mNativeInterface.data();
+}
+
+QPlatformWindow* QUbuntuIntegration::createPlatformWindow(QWindow* window) const
+{
+    QMirClientStartupTrace::Phase tracePhase("createPlatformWindow");
+    auto platformWindow = new QUbuntuWindow(window, mEglDisplay);
+    mInput->start();
+    return platformWindow;
+}
+
+QPlatformBackingStore* QUbuntuIntegration::createPlatformBackingStore(QWindow* window) const
+{
+    return new QMirClientBackingStore(window);
+}
+
+QPlatformOpenGLContext* QUbuntuIntegration::createPlatformOpenGLContext(QOpenGLContext* context) const
+{
+    const QSurfaceFormat format(context->format());
+    const EGLConfig config = q_configFromGLFormat(mEglDisplay, format, false, EGL_PBUFFER_BIT);
+    if (!config) {
+        qCWarning(ubuntu, "No EGL config supporting pbuffers matches the requested format");
+        return nullptr;
+    }
+    return new QUbuntuOpenGLContext(format, context->shareHandle(), mEglDisplay, config, mSurfaceless,
+                                    mScreen->frameRate());
+}
+
+QPlatformOffscreenSurface *QUbuntuIntegration::createPlatformOffscreenSurface(QOffscreenSurface *surface) const
+{
+    if (mSurfaceless) {
+        return new QUbuntuOffscreenSurface(surface);
+    }
+    return new QEGLPbuffer(mEglDisplay, surface->requestedFormat(), surface);
+}
@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QUBUNTUINTEGRATION_H
+#define QUBUNTUINTEGRATION_H
+
+#include <qpa/qplatformintegration.h>
+#include <QScopedPointer>
+
+#include <EGL/egl.h>
+
+class QMirClientProgramBinaryCache;
+class QUbuntuInput;
+class QUbuntuNativeInterface;
+class QUbuntuScreen;
+
+/*
+ * QUbuntuIntegration - headless platform rendering with EGL, without any compositor.
+ *
+ * Meant to profile applications and the code shared with ubuntumirclient (backing store,
+ * frame timings, program binary cache) with tools like perf or heaptrack. The EGL display is
+ * the Mesa surfaceless platform when available, the default display otherwise.
+ */
+class QUbuntuIntegration : public QPlatformIntegration
+{
+public:
+    QUbuntuIntegration();
+    virtual ~QUbuntuIntegration();
+
+    // QPlatformIntegration methods.
+    bool hasCapability(QPlatformIntegration::Capability cap) const override;
+    QAbstractEventDispatcher *createEventDispatcher() const override;
+    QPlatformNativeInterface* nativeInterface() const override;
+    QPlatformBackingStore* createPlatformBackingStore(QWindow* window) const override;
+    QPlatformOpenGLContext* createPlatformOpenGLContext(QOpenGLContext* context) const override;
+    QPlatformFontDatabase* fontDatabase() const override { return mFontDb.data(); }
+    QPlatformWindow* createPlatformWindow(QWindow* window) const override;
+    QPlatformOffscreenSurface *createPlatformOffscreenSurface(QOffscreenSurface *surface) const override;
+    void initialize() override;
+
+    // New methods.
+    EGLDisplay eglDisplay() const { return mEglDisplay; }
+    QMirClientProgramBinaryCache *programBinaryCache() const { return mProgramBinaryCache.data(); }
+
+private:
+    void initializeEgl();
+
+    QScopedPointer<QUbuntuNativeInterface> mNativeInterface;
+    QScopedPointer<QPlatformFontDatabase> mFontDb;
+    QScopedPointer<QMirClientProgramBinaryCache> mProgramBinaryCache;
+    QScopedPointer<QUbuntuInput> mInput;
+    QUbuntuScreen *mScreen;
+
+    EGLDisplay mEglDisplay;
+    bool mSurfaceless;
+};
+
+#endif // QUBUNTUINTEGRATION_H
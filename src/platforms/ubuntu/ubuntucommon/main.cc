@@ -15,33 +15,40 @@
 
 #include <qpa/qplatformintegrationplugin.h>
 #include "integration.h"
+#include "logging.h"
 
-QT_BEGIN_NAMESPACE
+#include "../../../ubuntumirclient/qmirclientstartuptrace.h"
 
-class QUbuntuIntegrationPlugin : public QPlatformIntegrationPlugin {
-  Q_OBJECT
-  Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPA.QPlatformIntegrationFactoryInterface.5.1"
-                    FILE "ubuntu.json")
+Q_LOGGING_CATEGORY(ubuntu, "qt.qpa.ubuntu", QtWarningMsg)
+Q_LOGGING_CATEGORY(ubuntuInput, "qt.qpa.ubuntu.input", QtWarningMsg)
+// Used by the code shared with ubuntumirclient
+Q_LOGGING_CATEGORY(mirclient, "qt.qpa.mirclient", QtWarningMsg)
+Q_LOGGING_CATEGORY(mirclientGraphics, "qt.qpa.mirclient.graphics", QtWarningMsg)
 
- public:
-  QStringList keys() const;
-  QPlatformIntegration* create(const QString&, const QStringList&);
-};
+class QUbuntuIntegrationPlugin : public QPlatformIntegrationPlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID QPlatformIntegrationFactoryInterface_iid FILE "ubuntu.json")
 
-QStringList QUbuntuIntegrationPlugin::keys() const {
-  QStringList list;
-  list << "ubuntu";
-  return list;
-}
+public:
+    QPlatformIntegration *create(const QString &system, const QStringList &paramList) override;
+};
 
-QPlatformIntegration* QUbuntuIntegrationPlugin::create(
-    const QString& system, const QStringList& paramList) {
-  Q_UNUSED(paramList);
-  if (system.toLower() == "ubuntu")
-    return new QUbuntuIntegration();
-  return 0;
+QPlatformIntegration *QUbuntuIntegrationPlugin::create(const QString &system, const QStringList &/*paramList*/)
+{
+    if (system.toLower() != QLatin1String("ubuntu")) {
+        return nullptr;
+    }
+
+    QMirClientStartupTrace::addMark("pluginCreate");
+
+    // Without EGL there is nothing to render with, let Qt report the platform as unavailable
+    QUbuntuIntegration *integration = new QUbuntuIntegration;
+    if (integration->eglDisplay() == EGL_NO_DISPLAY) {
+        delete integration;
+        return nullptr;
+    }
+    return integration;
 }
 
-QT_END_NAMESPACE
-
 #include "main.moc"
@@ -0,0 +1,144 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "nativeinterface.h"
+#include "integration.h"
+#include "window.h"
+
+#include "../../../ubuntumirclient/qmirclientframetimings.h"
+#include "../../../ubuntumirclient/qmirclientprogrambinarycache.h"
+
+#include <QOpenGLContext>
+#include <QtGui/private/qguiapplication_p.h>
+#include <QtPlatformSupport/private/qeglplatformcontext_p.h>
+
+namespace {
+
+QMirClientProgramBinaryCache *programBinaryCache()
+{
+    auto integration = static_cast<QUbuntuIntegration*>(QGuiApplicationPrivate::platformIntegration());
+    return integration->programBinaryCache();
+}
+
+bool loadProgramBinary(GLuint program, const QByteArray &sources)
+{
+    return programBinaryCache()->load(program, sources);
+}
+
+void saveProgramBinary(GLuint program, const QByteArray &sources)
+{
+    programBinaryCache()->save(program, sources);
+}
+
+} // anonymous namespace
+
+QUbuntuNativeInterface::QUbuntuNativeInterface(const QUbuntuIntegration *integration)
+    : mIntegration(integration)
+{
+}
+
+void* QUbuntuNativeInterface::nativeResourceForIntegration(const QByteArray &resourceString)
+{
+    if (qstricmp(resourceString.constData(), "egldisplay") == 0) {
+        return mIntegration->eglDisplay();
+    }
+    return nullptr;
+}
+
+QPlatformNativeInterface::NativeResourceForIntegrationFunction
+QUbuntuNativeInterface::nativeResourceFunctionForIntegration(const QByteArray &resourceString)
+{
+    // Same signatures as with ubuntumirclient, declared in qmirclientprogrambinarycache.h
+    if (qstricmp(resourceString.constData(), "loadprogrambinary") == 0) {
+        const QMirClientLoadProgramBinaryFunction function = &loadProgramBinary;
+        return reinterpret_cast<NativeResourceForIntegrationFunction>(function);
+    } else if (qstricmp(resourceString.constData(), "saveprogrambinary") == 0) {
+        const QMirClientSaveProgramBinaryFunction function = &saveProgramBinary;
+        return reinterpret_cast<NativeResourceForIntegrationFunction>(function);
+    }
+    return nullptr;
+}
+
+void* QUbuntuNativeInterface::nativeResourceForContext(const QByteArray& resourceString, QOpenGLContext* context)
+{
+    if (!context || !context->handle()) {
+        return nullptr;
+    }
+
+    if (qstricmp(resourceString.constData(), "eglcontext") == 0) {
+        return static_cast<QEGLPlatformContext*>(context->handle())->eglContext();
+    } else if (qstricmp(resourceString.constData(), "egldisplay") == 0) {
+        return mIntegration->eglDisplay();
+    }
+    return nullptr;
+}
+
+QVariantMap QUbuntuNativeInterface::windowProperties(QPlatformWindow *window) const
+{
+    QVariantMap properties;
+    properties.insert(QStringLiteral("frameTimings"), windowProperty(window, QStringLiteral("frameTimings")));
+    return properties;
+}
+
+QVariant QUbuntuNativeInterface::windowProperty(QPlatformWindow *window, const QString &name) const
+{
+    if (!window || name != QStringLiteral("frameTimings")) {
+        return QVariant();
+    }
+
+    // Frame times as with ubuntumirclient, without GPU times
+    QVariantList frames;
+    Q_FOREACH (const auto &frame, static_cast<QUbuntuWindow*>(window)->frameTimings()->frames()) {
+        QVariantMap frameMap;
+        frameMap.insert("frame", frame.number);
+        frameMap.insert("cpuSubmitTime", frame.cpuSubmitTime / 1000);
+        frameMap.insert("gpuTime", -1);
+        frameMap.insert("swapBlockTime", frame.swapBlockTime / 1000);
+        frames.append(frameMap);
+    }
+    return frames;
+}
+
+QVariant QUbuntuNativeInterface::windowProperty(QPlatformWindow *window, const QString &name,
+                                                const QVariant &defaultValue) const
+{
+    const QVariant value = windowProperty(window, name);
+    return value.isValid() ? value : defaultValue;
+}
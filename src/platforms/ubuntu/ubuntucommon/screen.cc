@@ -0,0 +1,89 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "screen.h"
+#include "logging.h"
+
+#include <QRegularExpression>
+
+namespace {
+
+const QSize defaultSize(1920, 1080);
+const qreal defaultRefreshRate = 60.0;
+const qreal millimetersPerPixel = 25.4 / 96.0;
+
+QSize sizeFromEnvironment()
+{
+    const QByteArray value = qgetenv("QTUBUNTU_HEADLESS_SCREEN_SIZE");
+    if (value.isEmpty()) {
+        return defaultSize;
+    }
+
+    const QRegularExpressionMatch match =
+            QRegularExpression(QStringLiteral("^(\\d+)x(\\d+)$")).match(QString::fromLatin1(value));
+    const QSize size = match.hasMatch() ? QSize(match.captured(1).toInt(), match.captured(2).toInt()) : QSize();
+    if (size.isEmpty()) {
+        qCWarning(ubuntu, "Ignoring invalid QTUBUNTU_HEADLESS_SCREEN_SIZE \"%s\"", value.constData());
+        return defaultSize;
+    }
+    return size;
+}
+
+qreal frameRateFromEnvironment()
+{
+    bool ok;
+    const qreal rate = qgetenv("QTUBUNTU_HEADLESS_FRAME_RATE").toDouble(&ok);
+    return ok && rate >= 0 ? rate : defaultRefreshRate;
+}
+
+} // anonymous namespace
+
+QUbuntuScreen::QUbuntuScreen()
+    : mGeometry(QPoint(), sizeFromEnvironment())
+    , mPhysicalSize(QSizeF(mGeometry.size()) * millimetersPerPixel)
+    , mFrameRate(frameRateFromEnvironment())
+{
+    qCDebug(ubuntu, "Headless screen of %dx%d at %.1fHz", mGeometry.width(), mGeometry.height(), mFrameRate);
+}
+
+qreal QUbuntuScreen::refreshRate() const
+{
+    return mFrameRate > 0 ? mFrameRate : defaultRefreshRate;
+}
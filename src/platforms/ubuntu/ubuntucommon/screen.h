@@ -0,0 +1,75 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QUBUNTUSCREEN_H
+#define QUBUNTUSCREEN_H
+
+#include <qpa/qplatformscreen.h>
+
+/*
+ * QUbuntuScreen - the one screen of the headless platform.
+ *
+ * Its size comes from QTUBUNTU_HEADLESS_SCREEN_SIZE ("<width>x<height>", 1920x1080 by default)
+ * and the rate frames get throttled to from QTUBUNTU_HEADLESS_FRAME_RATE (60 by default, 0 to
+ * render as fast as possible).
+ */
+class QUbuntuScreen : public QPlatformScreen
+{
+public:
+    QUbuntuScreen();
+
+    // QPlatformScreen methods.
+    QImage::Format format() const override { return QImage::Format_RGB32; }
+    int depth() const override { return 32; }
+    QRect geometry() const override { return mGeometry; }
+    QSizeF physicalSize() const override { return mPhysicalSize; }
+    qreal refreshRate() const override;
+    QString name() const override { return QStringLiteral("headless"); }
+
+    // New methods.
+    qreal frameRate() const { return mFrameRate; }
+
+private:
+    QRect mGeometry;
+    QSizeF mPhysicalSize;
+    qreal mFrameRate;
+};
+
+#endif // QUBUNTUSCREEN_H
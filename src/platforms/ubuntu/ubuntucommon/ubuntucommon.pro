@@ -0,0 +1,55 @@
+TARGET = qpa-ubuntu
+TEMPLATE = lib
+
+QT -= gui
+QT += core-private platformsupport-private
+
+CONFIG += plugin no_keywords qpa/genericunixfontdatabase
+
+DEFINES += MESA_EGL_NO_X11_HEADERS
+# CONFIG += c++11 # only enables C++0x
+QMAKE_CXXFLAGS += -fvisibility=hidden -fvisibility-inlines-hidden -std=c++11 -Werror -Wall
+QMAKE_LFLAGS += -std=c++11 -Wl,-no-undefined
+
+CONFIG += link_pkgconfig
+PKGCONFIG += egl
+
+# Code shared with the ubuntumirclient plugin, none of which depends on Mir
+SHARED = ../../../ubuntumirclient
+
+SOURCES = \
+    glcontext.cc \
+    input.cc \
+    integration.cc \
+    main.cc \
+    nativeinterface.cc \
+    screen.cc \
+    window.cc \
+    $$SHARED/qmirclientbackingstore.cpp \
+    $$SHARED/qmirclientframetimings.cpp \
+    $$SHARED/qmirclientprocessmemory.cpp \
+    $$SHARED/qmirclientprogrambinarycache.cpp \
+    $$SHARED/qmirclientstartuptrace.cpp
+
+HEADERS = \
+    glcontext.h \
+    input.h \
+    integration.h \
+    logging.h \
+    nativeinterface.h \
+    screen.h \
+    window.h \
+    $$SHARED/qmirclientbackingstore.h \
+    $$SHARED/qmirclientextensions.h \
+    $$SHARED/qmirclientframetimings.h \
+    $$SHARED/qmirclientprocessmemory.h \
+    $$SHARED/qmirclientprogrambinarycache.h \
+    $$SHARED/qmirclientstartuptrace.h
+
+OTHER_FILES += \
+    ubuntu.json
+
+# Installation path
+target.path +=  $$[QT_INSTALL_PLUGINS]/platforms
+
+INSTALLS += target
@@ -0,0 +1,178 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "window.h"
+#include "logging.h"
+
+#include "../../../ubuntumirclient/qmirclientframetimings.h"
+
+#include <QAtomicInt>
+#include <QMutexLocker>
+#include <qpa/qplatformscreen.h>
+#include <qpa/qwindowsysteminterface.h>
+
+namespace {
+
+WId makeId()
+{
+    static QAtomicInt id(0);
+    return id.fetchAndAddRelaxed(1) + 1;
+}
+
+} // anonymous namespace
+
+QUbuntuWindow::QUbuntuWindow(QWindow *window, EGLDisplay display)
+    : QPlatformWindow(window)
+    , mId(makeId())
+    , mEglDisplay(display)
+    , mFrameTimings(new QMirClientFrameTimings)
+    , mExposed(false)
+    , mEglSurface(EGL_NO_SURFACE)
+    , mEglSurfaceConfig(nullptr)
+{
+    const QRect screenGeometry = screen()->geometry();
+    QRect rect;
+    if (window->windowState() == Qt::WindowFullScreen || window->windowState() == Qt::WindowMaximized) {
+        rect = screenGeometry;
+    } else {
+        rect = initialGeometry(window, window->geometry(), screenGeometry.width(), screenGeometry.height());
+    }
+    updateGeometry(rect);
+
+    qCDebug(ubuntu, "QUbuntuWindow(window=%p, id=%d) - %dx%d", window, static_cast<int>(mId),
+            rect.width(), rect.height());
+}
+
+QUbuntuWindow::~QUbuntuWindow()
+{
+    QMutexLocker lock(&mMutex);
+    destroyEglSurface();
+}
+
+void QUbuntuWindow::updateGeometry(const QRect &rect)
+{
+    QPlatformWindow::setGeometry(rect);
+    {
+        QMutexLocker lock(&mMutex);
+        mSize = rect.size();
+    }
+    QWindowSystemInterface::handleGeometryChange(window(), rect);
+    if (mExposed) {
+        QWindowSystemInterface::handleExposeEvent(window(), QRect(QPoint(), rect.size()));
+    }
+}
+
+void QUbuntuWindow::setGeometry(const QRect &rect)
+{
+    if (window()->windowState() == Qt::WindowFullScreen || window()->windowState() == Qt::WindowMaximized) {
+        return;
+    }
+    updateGeometry(rect);
+}
+
+void QUbuntuWindow::setWindowState(Qt::WindowState state)
+{
+    switch (state) {
+    case Qt::WindowFullScreen:
+    case Qt::WindowMaximized:
+        updateGeometry(screen()->geometry());
+        break;
+    default:
+        break;
+    }
+}
+
+void QUbuntuWindow::setVisible(bool visible)
+{
+    if (mExposed == visible) {
+        return;
+    }
+    mExposed = visible;
+
+    QWindowSystemInterface::handleExposeEvent(window(), visible ? QRect(QPoint(), geometry().size()) : QRect());
+    if (visible && !(window()->flags() & Qt::WindowDoesNotAcceptFocus)) {
+        requestActivateWindow();
+    }
+}
+
+bool QUbuntuWindow::isExposed() const
+{
+    return mExposed;
+}
+
+void QUbuntuWindow::requestActivateWindow()
+{
+    QWindowSystemInterface::handleWindowActivated(window(), Qt::ActiveWindowFocusReason);
+}
+
+EGLSurface QUbuntuWindow::eglSurface(EGLConfig config)
+{
+    QMutexLocker lock(&mMutex);
+
+    if (mEglSurface != EGL_NO_SURFACE && mEglSurfaceConfig == config && mEglSurfaceSize == mSize) {
+        return mEglSurface;
+    }
+
+    // Destroying a surface still current only takes effect once it no longer is
+    destroyEglSurface();
+
+    const EGLint attributes[] = {
+        EGL_WIDTH, mSize.width(),
+        EGL_HEIGHT, mSize.height(),
+        EGL_NONE
+    };
+    mEglSurface = eglCreatePbufferSurface(mEglDisplay, config, attributes);
+    if (mEglSurface == EGL_NO_SURFACE) {
+        qCWarning(ubuntu, "Could not create a %dx%d pbuffer for window %p (EGL error 0x%x)",
+                  mSize.width(), mSize.height(), window(), eglGetError());
+        return EGL_NO_SURFACE;
+    }
+    mEglSurfaceConfig = config;
+    mEglSurfaceSize = mSize;
+    return mEglSurface;
+}
+
+void QUbuntuWindow::destroyEglSurface()
+{
+    if (mEglSurface != EGL_NO_SURFACE) {
+        eglDestroySurface(mEglDisplay, mEglSurface);
+        mEglSurface = EGL_NO_SURFACE;
+    }
+}
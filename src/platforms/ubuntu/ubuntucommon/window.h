@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QUBUNTUWINDOW_H
+#define QUBUNTUWINDOW_H
+
+#include <qpa/qplatformwindow.h>
+#include <QMutex>
+#include <QSharedPointer>
+
+#include <EGL/egl.h>
+
+class QMirClientFrameTimings;
+
+/*
+ * QUbuntuWindow - a window of the headless platform, rendered into an EGL pbuffer.
+ *
+ * The pbuffer is created on first use by the thread rendering the window, with the config of
+ * the context made current on it, and recreated there once the window got resized.
+ */
+class QUbuntuWindow : public QPlatformWindow
+{
+public:
+    QUbuntuWindow(QWindow *window, EGLDisplay display);
+    virtual ~QUbuntuWindow();
+
+    // QPlatformWindow methods.
+    WId winId() const override { return mId; }
+    void setGeometry(const QRect &rect) override;
+    void setWindowState(Qt::WindowState state) override;
+    void setVisible(bool visible) override;
+    bool isExposed() const override;
+    void requestActivateWindow() override;
+    QSurfaceFormat format() const override { return window()->requestedFormat(); }
+
+    // New methods.
+    EGLSurface eglSurface(EGLConfig config);
+    QSharedPointer<QMirClientFrameTimings> frameTimings() const { return mFrameTimings; }
+
+    // Only used by the thread rendering the window. Start of the frame being rendered, -1 if none.
+    qint64 frameStart{-1};
+
+private:
+    void updateGeometry(const QRect &rect);
+    void destroyEglSurface();
+
+    const WId mId;
+    const EGLDisplay mEglDisplay;
+    const QSharedPointer<QMirClientFrameTimings> mFrameTimings;
+    bool mExposed;
+
+    mutable QMutex mMutex;
+    QSize mSize;
+    EGLSurface mEglSurface;
+    EGLConfig mEglSurfaceConfig;
+    QSize mEglSurfaceSize;
+};
+
+#endif // QUBUNTUWINDOW_H
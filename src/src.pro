@@ -1,3 +1,3 @@
 TEMPLATE = subdirs
 
-SUBDIRS += ubuntumirclient ubuntuappmenu
+SUBDIRS += ubuntumirclient ubuntuappmenu platforms/ubuntu/ubuntucommon
@@ -41,6 +41,7 @@
 #include "qmirclientappstatecontroller.h"
 
 #include <qpa/qwindowsysteminterface.h>
+#include <QThread>
 
 /*
  * QMirClientAppStateController - updates Qt's QApplication::applicationState property.
@@ -52,11 +53,13 @@
 QMirClientAppStateController::QMirClientAppStateController()
     : m_suspended(false)
     , m_lastActive(true)
+    , m_active(true)
 {
     m_inactiveTimer.setSingleShot(true);
     m_inactiveTimer.setInterval(10);
-    QObject::connect(&m_inactiveTimer, &QTimer::timeout, []()
+    QObject::connect(&m_inactiveTimer, &QTimer::timeout, [this]()
     {
+        m_active = false;
         QWindowSystemInterface::handleApplicationStateChanged(Qt::ApplicationInactive);
     });
 }
@@ -66,8 +69,15 @@ void QMirClientAppStateController::setSuspended()
     m_inactiveTimer.stop();
     if (!m_suspended) {
         m_suspended = true;
+        m_active = false;
 
         QWindowSystemInterface::handleApplicationStateChanged(Qt::ApplicationSuspended);
+
+        // May be called from a platform-api thread. The process gets stopped as soon as the
+        // about-to-stop callback returns, so the trim has to be over by then.
+        const bool guiThread = QThread::currentThread() == m_suspendTrimmer.thread();
+        QMetaObject::invokeMethod(&m_suspendTrimmer, "trim",
+                                  guiThread ? Qt::DirectConnection : Qt::BlockingQueuedConnection);
     }
 }
 
@@ -77,6 +87,9 @@ void QMirClientAppStateController::setResumed()
     if (m_suspended) {
         m_suspended = false;
 
+        QMetaObject::invokeMethod(&m_suspendTrimmer, "restore", Qt::QueuedConnection);
+
+        m_active = m_lastActive;
         if (m_lastActive) {
             QWindowSystemInterface::handleApplicationStateChanged(Qt::ApplicationActive);
         } else {
@@ -93,6 +106,7 @@ void QMirClientAppStateController::setWindowFocused(bool focused)
 
     if (focused) {
         m_inactiveTimer.stop();
+        m_active = true;
         QWindowSystemInterface::handleApplicationStateChanged(Qt::ApplicationActive);
     } else {
         m_inactiveTimer.start();
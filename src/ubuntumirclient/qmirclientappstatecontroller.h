@@ -43,6 +43,10 @@
 
 #include <QTimer>
 
+#include <atomic>
+
+#include "qmirclientsuspendtrimmer.h"
+
 class QMirClientAppStateController
 {
 public:
@@ -53,10 +57,15 @@ public:
 
     void setWindowFocused(bool focused);
 
+    // Whether the application state is Qt::ApplicationActive. Thread-safe.
+    bool isActive() const { return m_active; }
+
 private:
     bool m_suspended;
     bool m_lastActive;
+    std::atomic<bool> m_active;
     QTimer m_inactiveTimer;
+    QMirClientSuspendTrimmer m_suspendTrimmer;
 };
 
 #endif // QMIRCLIENTAPPSTATECONTROLLER_H
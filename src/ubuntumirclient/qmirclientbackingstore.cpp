@@ -46,6 +46,14 @@
 #include <QtGui/QMatrix4x4>
 #include <QtGui/private/qopengltextureblitter_p.h>
 #include <QtGui/qopenglfunctions.h>
+#include <QVector>
+
+namespace {
+
+// Only used from the GUI thread
+QVector<QMirClientBackingStore*> backingStores;
+
+} // anonymous namespace
 
 QMirClientBackingStore::QMirClientBackingStore(QWindow* window)
     : QPlatformBackingStore(window)
@@ -58,25 +66,42 @@ QMirClientBackingStore::QMirClientBackingStore(QWindow* window)
     mContext->create();
 
     window->setSurfaceType(QSurface::OpenGLSurface);
+
+    backingStores.append(this);
 }
 
 QMirClientBackingStore::~QMirClientBackingStore()
 {
-    if (!mTexture->isCreated())
+    backingStores.removeOne(this);
+
+    if (!mTexture->isCreated() && !mBlitter->isCreated())
         return;
 
     // Paraphrasing QOpenGLCompositorBackingStore: "With render-to-texture-widgets QWidget makes
     // sure the context is made current before destroying backingstores. That is however not the
     // case for windows with regular widgets only."
-    auto context = QOpenGLContext::currentContext();
-    if (!context) { // QWindow's backing QPlatformSurface probably gone, use temp one for cleanup
-        QOffscreenSurface tempSurface;
+    // The temporary surface must outlive the GL calls, so the resources are destroyed here rather
+    // than along with the members.
+    QOffscreenSurface tempSurface;
+    bool madeCurrent = false;
+    if (!QOpenGLContext::currentContext()) { // QWindow's backing QPlatformSurface probably gone, use temp one for cleanup
         tempSurface.setFormat(mContext->format());
         tempSurface.create();
-        mContext->makeCurrent(&tempSurface);
+        madeCurrent = mContext->makeCurrent(&tempSurface);
+    }
+
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (!context || !QOpenGLContext::areSharing(context, mContext.data())) {
+        qCWarning(mirclientGraphics, "Leaking the GL resources of a backing store, its context can't be made current");
+        return;
     }
-    // QOpenGLTexture will go out of scope, is then deleted. Then QOpenGLContext falls out of
-    // scope, calls doneCurrent and is then deleted.
+
+    if (mTexture->isCreated())
+        mTexture->destroy();
+    mBlitter->destroy();
+
+    if (madeCurrent)
+        mContext->doneCurrent();
 }
 
 void QMirClientBackingStore::flush(QWindow* window, const QRegion& region, const QPoint& offset)
@@ -145,6 +170,34 @@ void QMirClientBackingStore::updateTexture()
 }
 
 
+void QMirClientBackingStore::releaseAllResources()
+{
+    for (QMirClientBackingStore *backingStore : backingStores) {
+        backingStore->releaseResources();
+    }
+}
+
+void QMirClientBackingStore::releaseResources()
+{
+    if (mTexture->isCreated() || mBlitter->isCreated()) {
+        QOffscreenSurface tempSurface;
+        tempSurface.setFormat(mContext->format());
+        tempSurface.create();
+        if (!mContext->makeCurrent(&tempSurface)) {
+            return;
+        }
+
+        if (mTexture->isCreated()) {
+            mTexture->destroy();
+        }
+        mBlitter->destroy();
+        mContext->doneCurrent();
+    }
+
+    // The texture gets recreated from the whole image
+    mDirty = mImage.rect();
+}
+
 void QMirClientBackingStore::beginPaint(const QRegion& region)
 {
     mDirty |= region;
@@ -60,7 +60,13 @@ public:
     QPaintDevice* paintDevice() override;
     QImage toImage() const override;
 
+    // New methods.
+    // Frees the GL resources of every backing store, recreated on their next flush. The images
+    // are kept as Qt only repaints the regions it knows to be dirty.
+    static void releaseAllResources();
+
 protected:
+    void releaseResources();
     void updateTexture();
 
 private:
@@ -40,11 +40,13 @@
 
 #include "qmirclientclipboard.h"
 #include "qmirclientlogging.h"
+#include "qmirclientperfcounters.h"
 #include "qmirclientwindow.h"
 
 #include <QDBusPendingCallWatcher>
 #include <QGuiApplication>
-#include <QSignalBlocker>
+#include <QInputMethodQueryEvent>
+#include <qpa/qplatformnativeinterface.h>
 #include <QtCore/QMimeData>
 #include <QtCore/QStringList>
 
@@ -54,21 +56,51 @@
 // get this cumbersome nested namespace out of the way
 using namespace com::ubuntu::content;
 
-QMirClientClipboard::QMirClientClipboard()
-    : mMimeData(new QMimeData)
-    , mContentHub(Hub::Client::instance())
+namespace {
+
+// Pastes travel in a single D-Bus message and dbus-daemon drops the connection of anyone
+// sending one above its limit (32 MiB by default), so stay well clear of it.
+const qint64 defaultMaxPasteSize = 24 * 1024 * 1024;
+
+qint64 maxPasteSize()
 {
-    connect(mContentHub, &Hub::pasteboardChanged, this, [this]() {
-        if (mClipboardState == QMirClientClipboard::SyncedClipboard) {
-            mClipboardState = QMirClientClipboard::OutdatedClipboard;
-            emitChanged(QClipboard::Clipboard);
+    bool ok;
+    const qint64 maxSizeKb = qgetenv("QTUBUNTU_CLIPBOARD_MAX_SIZE").toLongLong(&ok);
+    return ok && maxSizeKb >= 0 ? maxSizeKb * 1024 : defaultMaxPasteSize;
+}
+
+// Copy of the clip holding each format serialized, as content-hub sends it. Null as soon as it
+// outgrows maxSize, sparing the conversion of the remaining formats (such as encoding an image).
+QMimeData *serializedPaste(const QMimeData &mimeData, qint64 maxSize)
+{
+    QScopedPointer<QMimeData> serialized(new QMimeData);
+    qint64 size = 0;
+    Q_FOREACH (const QString &format, mimeData.formats()) {
+        const QByteArray data = mimeData.data(format);
+        size += format.size() * 2 + data.size();
+        if (size > maxSize) {
+            qCWarning(mirclient, "Not sharing a clip of over %lld bytes through content-hub, the limit is %lld bytes",
+                      size, maxSize);
+            return nullptr;
         }
-    });
+        serialized->setData(format, data);
+    }
+    return serialized.take();
+}
+
+} // anonymous namespace
 
+QMirClientClipboard::QMirClientClipboard()
+    : mMimeData(new QMimeData)
+{
     connect(qGuiApp, &QGuiApplication::applicationStateChanged,
         this, &QMirClientClipboard::onApplicationStateChanged);
 
-    requestMimeData();
+    connect(qGuiApp, &QGuiApplication::focusObjectChanged,
+        this, &QMirClientClipboard::onFocusObjectChanged);
+
+    connect(QGuiApplication::platformNativeInterface(), &QPlatformNativeInterface::windowPropertyChanged,
+        this, &QMirClientClipboard::onWindowPropertyChanged);
 }
 
 QMirClientClipboard::~QMirClientClipboard()
@@ -81,14 +113,13 @@ QMimeData* QMirClientClipboard::mimeData(QClipboard::Mode mode)
     if (mode != QClipboard::Clipboard)
         return nullptr;
 
-    // Blocks dataChanged() signal from being emitted. Makes no sense to emit it from
-    // inside the data getter.
-    const QSignalBlocker blocker(this);
+    mClipboardUsed = true;
 
+    // Never wait for content-hub here, that would block the GUI thread on a D-Bus round trip.
+    // What we have is returned in the meantime and dataChanged() gets emitted once the latest
+    // paste arrives.
     if (mClipboardState == OutdatedClipboard) {
-        updateMimeData();
-    } else if (mClipboardState == SyncingClipboard) {
-        mPasteReply->waitForFinished();
+        requestMimeData();
     }
 
     return mMimeData;
@@ -96,21 +127,29 @@ QMimeData* QMirClientClipboard::mimeData(QClipboard::Mode mode)
 
 void QMirClientClipboard::setMimeData(QMimeData* mimeData, QClipboard::Mode mode)
 {
-    QWindow *focusWindow = QGuiApplication::focusWindow();
-    if (focusWindow && mode == QClipboard::Clipboard && mimeData != nullptr) {
-        QString surfaceId = static_cast<QMirClientWindow*>(focusWindow->handle())->persistentSurfaceId();
+    if (mode != QClipboard::Clipboard || mimeData == nullptr || mimeData == mMimeData) {
+        return;
+    }
 
-        QDBusPendingCall reply = mContentHub->createPaste(surfaceId, *mimeData);
+    mClipboardUsed = true;
 
-        // Don't care whether it succeeded
-        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
-        connect(watcher, &QDBusPendingCallWatcher::finished,
-                watcher, &QObject::deleteLater);
+    // Without a focused window content-hub would refuse the paste, but the clip still
+    // belongs to us and stays available within the application.
+    mSharePending = QGuiApplication::focusWindow() != nullptr;
 
-        mMimeData = mimeData;
-        mClipboardState = SyncedClipboard;
-        emitChanged(QClipboard::Clipboard);
+    // Our own paste supersedes whatever we were fetching
+    if (mPasteReply) {
+        mPasteReply->disconnect(this);
+        mPasteReply->deleteLater();
+        mPasteReply = nullptr;
     }
+
+    // We own the mime data handed to us
+    delete mMimeData;
+    mMimeData = mimeData;
+    mClipboardState = SyncedClipboard;
+    sharePaste();
+    emitChanged(QClipboard::Clipboard);
 }
 
 bool QMirClientClipboard::supportsMode(QClipboard::Mode mode) const
@@ -126,7 +165,7 @@ bool QMirClientClipboard::ownsMode(QClipboard::Mode mode) const
 
 void QMirClientClipboard::onApplicationStateChanged(Qt::ApplicationState state)
 {
-    if (state == Qt::ApplicationActive) {
+    if (state == Qt::ApplicationActive && mClipboardUsed) {
         // Only focused or active applications might be allowed to paste, so we probably
         // missed changes in the clipboard while we were hidden, inactive or, more importantly,
         // suspended.
@@ -134,25 +173,101 @@ void QMirClientClipboard::onApplicationStateChanged(Qt::ApplicationState state)
     }
 }
 
-void QMirClientClipboard::updateMimeData()
+void QMirClientClipboard::onFocusObjectChanged(QObject *object)
 {
-    if (qGuiApp->applicationState() != Qt::ApplicationActive) {
-        // Don't even bother asking as content-hub would probably ignore our request (and should).
+    if (mClipboardUsed || !object) {
+        return;
+    }
+
+    // Text input is what gets pasted into. Fetching the clip as soon as some has focus makes it
+    // available to the first paste, while applications without any still never reach content-hub.
+    QInputMethodQueryEvent query(Qt::ImEnabled);
+    QCoreApplication::sendEvent(object, &query);
+    if (query.value(Qt::ImEnabled).toBool()) {
+        mClipboardUsed = true;
+        requestMimeData();
+    }
+}
+
+Hub *QMirClientClipboard::contentHub()
+{
+    if (!mContentHub) {
+        mContentHub = Hub::Client::instance();
+
+        connect(mContentHub, &Hub::pasteboardChanged, this, [this]() {
+            // A fetch in flight may predate the change
+            if (mPasteReply) {
+                mPasteReply->disconnect(this);
+                mPasteReply->deleteLater();
+                mPasteReply = nullptr;
+            }
+            mClipboardState = QMirClientClipboard::OutdatedClipboard;
+
+            // Fetched right away rather than on the next mimeData(), so that the new clip is at
+            // hand by the time it gets pasted. changed is emitted again once it arrives.
+            if (mClipboardUsed) {
+                requestMimeData();
+            }
+            emitChanged(QClipboard::Clipboard);
+        });
+    }
+    return mContentHub;
+}
+
+void QMirClientClipboard::onWindowPropertyChanged(QPlatformWindow *window, const QString &property)
+{
+    if (property != QStringLiteral("persistentSurfaceId")) {
         return;
     }
 
     QWindow *focusWindow = QGuiApplication::focusWindow();
-    if (focusWindow) {
-        delete mMimeData;
-        QString surfaceId = static_cast<QMirClientWindow*>(focusWindow->handle())->persistentSurfaceId();
-        mMimeData = mContentHub->latestPaste(surfaceId);
-        mClipboardState = SyncedClipboard;
-        emitChanged(QClipboard::Clipboard);
+    if (!focusWindow || focusWindow->handle() != window) {
+        return;
+    }
+
+    // Whatever got postponed for lack of an id can go ahead now
+    sharePaste();
+    if (mClipboardUsed && mClipboardState == OutdatedClipboard) {
+        requestMimeData();
+    }
+}
+
+void QMirClientClipboard::sharePaste()
+{
+    QWindow *focusWindow = QGuiApplication::focusWindow();
+    if (!mSharePending || !focusWindow) {
+        return;
+    }
+
+    QString surfaceId = static_cast<QMirClientWindow*>(focusWindow->handle())->persistentSurfaceId();
+    if (surfaceId.isEmpty()) {
+        // Not received from Mir yet, onWindowPropertyChanged() retries
+        return;
+    }
+
+    // Too big a clip stays local to the application
+    mSharePending = false;
+    QScopedPointer<QMimeData> serialized(serializedPaste(*mMimeData, maxPasteSize()));
+    if (!serialized) {
+        return;
     }
+
+    QDBusPendingCall reply = contentHub()->createPaste(surfaceId, *serialized);
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::ClipboardRoundTrips);
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::DBusRoundTrips);
+
+    // Don't care whether it succeeded
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished,
+            watcher, &QObject::deleteLater);
 }
 
 void QMirClientClipboard::requestMimeData()
 {
+    if (mClipboardState == SyncingClipboard) {
+        return;
+    }
+
     if (qGuiApp->applicationState() != Qt::ApplicationActive) {
         // Don't even bother asking as content-hub would probably ignore our request (and should).
         return;
@@ -164,7 +279,14 @@ void QMirClientClipboard::requestMimeData()
     }
 
     QString surfaceId = static_cast<QMirClientWindow*>(focusWindow->handle())->persistentSurfaceId();
-    QDBusPendingCall reply = mContentHub->requestLatestPaste(surfaceId);
+    if (surfaceId.isEmpty()) {
+        // Not received from Mir yet, onWindowPropertyChanged() retries
+        return;
+    }
+
+    QDBusPendingCall reply = contentHub()->requestLatestPaste(surfaceId);
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::ClipboardRoundTrips);
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::DBusRoundTrips);
     mClipboardState = SyncingClipboard;
 
     mPasteReply = new QDBusPendingCallWatcher(reply, this);
@@ -172,6 +294,8 @@ void QMirClientClipboard::requestMimeData()
             this, [this]() {
         delete mMimeData;
         mMimeData = mContentHub->paste(*mPasteReply);
+        // The remote data is not ours to share
+        mSharePending = false;
         mClipboardState = SyncedClipboard;
         mPasteReply->deleteLater();
         mPasteReply = nullptr;
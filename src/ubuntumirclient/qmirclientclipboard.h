@@ -55,6 +55,7 @@ namespace com {
 }
 
 class QDBusPendingCallWatcher;
+class QPlatformWindow;
 
 class QMirClientClipboard : public QObject, public QPlatformClipboard
 {
@@ -71,20 +72,30 @@ public:
 
 private Q_SLOTS:
     void onApplicationStateChanged(Qt::ApplicationState state);
+    void onFocusObjectChanged(QObject *object);
+    void onWindowPropertyChanged(QPlatformWindow *window, const QString &property);
 
 private:
-    void updateMimeData();
+    com::ubuntu::content::Hub *contentHub();
     void requestMimeData();
+    void sharePaste();
 
     QMimeData *mMimeData;
 
+    // Whether the application ever read or wrote the clipboard, or gave focus to text
+    // input. Content-hub isn't contacted before that.
+    bool mClipboardUsed{false};
+
+    // Our mimeData still has to be handed to ContentHub
+    bool mSharePending{false};
+
     enum {
         OutdatedClipboard, // Our mimeData is outdated, need to fetch latest from ContentHub
         SyncingClipboard, // Our mimeData is outdated and we are waiting for ContentHub to reply with the latest paste
         SyncedClipboard // Our mimeData is in sync with what ContentHub has
     } mClipboardState{OutdatedClipboard};
 
-    com::ubuntu::content::Hub *mContentHub;
+    com::ubuntu::content::Hub *mContentHub{nullptr};
 
     QDBusPendingCallWatcher *mPasteReply{nullptr};
 };
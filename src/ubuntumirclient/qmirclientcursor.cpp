@@ -41,6 +41,7 @@
 #include "qmirclientcursor.h"
 
 #include "qmirclientlogging.h"
+#include "qmirclientperfcounters.h"
 #include "qmirclientwindow.h"
 
 #include <mir_toolkit/mir_client_library.h>
@@ -151,6 +152,7 @@ public:
     void apply(MirWindow *window)
     {
         mir_window_apply_spec(window, spec);
+        QMirClientPerfCounters::increment(QMirClientPerfCounters::WindowSpecsApplied);
     }
 private:
     MirWindowSpec * const spec;
@@ -198,6 +200,7 @@ void QMirClientCursor::configureMirCursorWithPixmapQCursor(MirWindow *window, QC
 
     MirBufferStream *bufferStream = mir_connection_create_buffer_stream_sync(mConnection,
             image.width(), image.height(), mir_pixel_format_argb_8888, mir_buffer_usage_software);
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::CompositorRoundTrips);
 
     {
         MirGraphicsRegion region;
@@ -212,6 +215,7 @@ void QMirClientCursor::configureMirCursorWithPixmapQCursor(MirWindow *window, QC
     }
 
     mir_buffer_stream_swap_buffers_sync(bufferStream);
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::CompositorRoundTrips);
 
     {
         auto configuration = mir_cursor_configuration_from_buffer_stream(bufferStream, cursor.hotSpot().x(), cursor.hotSpot().y());
@@ -220,6 +224,7 @@ void QMirClientCursor::configureMirCursorWithPixmapQCursor(MirWindow *window, QC
     }
 
     mir_buffer_stream_release_sync(bufferStream);
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::CompositorRoundTrips);
 }
 
 void QMirClientCursor::applyDefaultCursorConfiguration(MirWindow *window)
@@ -41,6 +41,7 @@
 #include "qmirclientdebugextension.h"
 
 #include "qmirclientlogging.h"
+#include "qmirclientperfcounters.h"
 
 // mir client debug
 #include <mir_toolkit/extensions/window_coordinate_translation.h>
@@ -68,6 +69,7 @@ QPoint QMirClientDebugExtension::mapWindowPointToScreen(MirWindow *window, const
 
     QPoint mappedPoint;
     mExtension->window_translate_coordinates(window, point.x(), point.y(), &mappedPoint.rx(), &mappedPoint.ry());
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::CompositorRoundTrips);
 
     return mappedPoint;
 }
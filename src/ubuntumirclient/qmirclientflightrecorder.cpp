@@ -0,0 +1,227 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmirclientflightrecorder.h"
+#include "qmirclientlogging.h"
+
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+struct Ring
+{
+    QMirClientFlightRecorder::Entry entries[QMirClientFlightRecorder::Capacity];
+    std::atomic<quint64> count{0};
+    std::atomic<qint32> threadId{0};
+    std::atomic<bool> inUse{true};
+    Ring *next{nullptr};
+};
+
+// Rings are never freed, those of finished threads get reused by new ones
+std::atomic<Ring*> rings{nullptr};
+
+const bool enabled = qEnvironmentVariableIsEmpty("QTUBUNTU_NO_FLIGHT_RECORDER");
+
+char defaultDumpPath[256];
+
+Ring *acquireRing()
+{
+    const qint32 threadId = static_cast<qint32>(syscall(SYS_gettid));
+
+    for (Ring *ring = rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+        bool inUse = false;
+        if (ring->inUse.compare_exchange_strong(inUse, true)) {
+            // Entries of the previous thread would be attributed to this one
+            ring->count.store(0, std::memory_order_release);
+            ring->threadId = threadId;
+            return ring;
+        }
+    }
+
+    Ring *ring = new Ring;
+    ring->threadId = threadId;
+    ring->next = rings.load(std::memory_order_relaxed);
+    while (!rings.compare_exchange_weak(ring->next, ring)) {
+    }
+    return ring;
+}
+
+struct ThreadRing
+{
+    ~ThreadRing()
+    {
+        if (ring) {
+            ring->inUse.store(false, std::memory_order_release);
+        }
+    }
+
+    Ring *ring{nullptr};
+};
+
+thread_local ThreadRing threadRing;
+
+bool writeAll(int fd, const void *data, size_t size)
+{
+    const char *bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t written = ::write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+void dumpSignalHandler(int)
+{
+    const int savedErrno = errno;
+    QMirClientFlightRecorder::dump(nullptr);
+    errno = savedErrno;
+}
+
+} // anonymous namespace
+
+void QMirClientFlightRecorder::record(EventType type, const void *window, quint32 detail, int width, int height)
+{
+    if (!enabled) {
+        return;
+    }
+
+    Ring *ring = threadRing.ring;
+    if (Q_UNLIKELY(!ring)) {
+        ring = threadRing.ring = acquireRing();
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    // Only this thread writes to the ring, the dump may read a torn entry at worst
+    const quint64 count = ring->count.load(std::memory_order_relaxed);
+    Entry &entry = ring->entries[count % Capacity];
+    entry.timestamp = static_cast<quint64>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    entry.window = reinterpret_cast<quintptr>(window);
+    entry.type = type;
+    entry.detail = detail;
+    entry.width = width;
+    entry.height = height;
+    ring->count.store(count + 1, std::memory_order_release);
+}
+
+bool QMirClientFlightRecorder::dump(const char *path)
+{
+    if (!path) {
+        path = defaultDumpPath;
+    }
+    if (!enabled || !path[0]) {
+        return false;
+    }
+
+    const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+
+    quint32 threadCount = 0;
+    for (Ring *ring = rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+        ++threadCount;
+    }
+
+    const quint32 header[3] = { 1, sizeof(Entry), threadCount };
+    bool ok = writeAll(fd, "QUFR", 4) && writeAll(fd, header, sizeof(header));
+
+    Ring *ring = rings.load(std::memory_order_acquire);
+    for (quint32 i = 0; ok && i < threadCount; ++i, ring = ring->next) {
+        const quint64 count = ring->count.load(std::memory_order_acquire);
+        const quint32 entryCount = count < Capacity ? count : Capacity;
+        const qint32 threadHeader[2] = { ring->threadId.load(), static_cast<qint32>(entryCount) };
+        ok = writeAll(fd, threadHeader, sizeof(threadHeader));
+
+        // Oldest first: from the slot after the newest one to the end, then from the start
+        const quint32 newest = count % Capacity;
+        if (ok && count > Capacity) {
+            ok = writeAll(fd, &ring->entries[newest], (Capacity - newest) * sizeof(Entry));
+        }
+        if (ok) {
+            ok = writeAll(fd, &ring->entries[0], (count > Capacity ? newest : entryCount) * sizeof(Entry));
+        }
+    }
+
+    return ::close(fd) == 0 && ok;
+}
+
+void QMirClientFlightRecorder::installSignalHandler()
+{
+    if (!enabled) {
+        return;
+    }
+
+    const QByteArray path = qgetenv("QTUBUNTU_FLIGHT_RECORDER_FILE");
+    if (!path.isEmpty()) {
+        qstrncpy(defaultDumpPath, path.constData(), sizeof(defaultDumpPath));
+    } else {
+        snprintf(defaultDumpPath, sizeof(defaultDumpPath), "/tmp/qtubuntu-flightrecorder-%d", getpid());
+    }
+
+    // Leave the signal alone if the application has a use for it
+    struct sigaction action;
+    if (sigaction(SIGUSR2, nullptr, &action) != 0 || action.sa_handler != SIG_DFL) {
+        qCDebug(mirclient, "SIGUSR2 already handled, the flight recorder can only be dumped through the native interface");
+        return;
+    }
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = dumpSignalHandler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGUSR2, &action, nullptr);
+}
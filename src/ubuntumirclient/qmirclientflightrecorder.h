@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QMIRCLIENTFLIGHTRECORDER_H
+#define QMIRCLIENTFLIGHTRECORDER_H
+
+#include <QtGlobal>
+
+/*
+ * QMirClientFlightRecorder - always-on recorder of the plugin's hot path events.
+ *
+ * Each thread records into its own fixed-size ring of compact entries, so recording is a
+ * handful of stores with no locking nor allocation. The rings can be dumped through the
+ * "dumpflightrecorder" native function or by sending SIGUSR2 to the process (unless the
+ * application handles that signal itself), to QTUBUNTU_FLIGHT_RECORDER_FILE or else
+ * /tmp/qtubuntu-flightrecorder-<pid>. QTUBUNTU_NO_FLIGHT_RECORDER turns recording off.
+ *
+ * Dump format, native endianness:
+ *   header:  char magic[4] = "QUFR", quint32 version = 1, quint32 entrySize = 32, quint32 threadCount
+ *   then for each thread:  qint32 threadId, quint32 entryCount, followed by entryCount Entry, oldest first
+ */
+class QMirClientFlightRecorder
+{
+public:
+    enum EventType {
+        MirEventPosted = 1,     // detail: MirEventType, width/height set for resizes
+        MirEventDispatched = 2, // detail: MirEventType
+        SwapBuffersDone = 3,    // width/height: buffer size
+        WindowSpecApplied = 4,
+        ExposeSent = 5          // detail: 1 if exposed, width/height: exposed size
+    };
+
+    struct Entry {
+        quint64 timestamp;      // CLOCK_MONOTONIC, in ns
+        quint64 window;         // address of the QWindow, as in debug messages
+        quint32 type;
+        quint32 detail;
+        qint32 width;
+        qint32 height;
+    };
+
+    enum { Capacity = 4096 };
+
+    static void record(EventType type, const void *window, quint32 detail = 0, int width = 0, int height = 0);
+
+    // Async-signal-safe
+    static bool dump(const char *path);
+
+    static void installSignalHandler();
+};
+
+// Signature of the function exposed through QPlatformNativeInterface::nativeResourceFunctionForIntegration()
+// as "dumpflightrecorder". A null path dumps to the default file.
+typedef bool (*QMirClientDumpFlightRecorderFunction)(const char *path);
+
+#endif // QMIRCLIENTFLIGHTRECORDER_H
@@ -0,0 +1,74 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QMIRCLIENTFRAMERATEPOLICY_H
+#define QMIRCLIENTFRAMERATEPOLICY_H
+
+#include <mir_toolkit/common.h>
+
+#include <QtGlobal>
+
+class QMirClientAppStateController;
+
+/*
+ * QMirClientFrameRatePolicy - how often windows the user is not interacting with may render.
+ *
+ * The focused window renders at the display's rate, and so do the windows going along with it
+ * (see QMirClientWindow::updateFrameRateFocus()). Other windows of an application in use
+ * are capped to QTUBUNTU_UNFOCUSED_FRAME_RATE (30 Hz by default), the windows of an
+ * application in the background or not exposed to QTUBUNTU_BACKGROUND_FRAME_RATE (10 Hz by
+ * default), 0 lifting a cap. On form factors that are usually mains powered, monitors, TVs
+ * and projectors, the caps are one step more lenient.
+ */
+class QMirClientFrameRatePolicy
+{
+public:
+    QMirClientFrameRatePolicy(const QMirClientAppStateController *appStateController);
+
+    // In Hz, 0 if not capped. Thread-safe.
+    qreal frameRateCap(bool focused, bool exposed, MirFormFactor formFactor) const;
+
+private:
+    const QMirClientAppStateController * const mAppStateController;
+    const qreal mUnfocusedRate;
+    const qreal mBackgroundRate;
+};
+
+#endif // QMIRCLIENTFRAMERATEPOLICY_H
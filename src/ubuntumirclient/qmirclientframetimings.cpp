@@ -0,0 +1,80 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmirclientframetimings.h"
+
+#include <QMutexLocker>
+
+quint64 QMirClientFrameTimings::addFrame(qint64 cpuSubmitTime, qint64 swapBlockTime)
+{
+    QMutexLocker lock(&mMutex);
+
+    const quint64 number = mFrameCount++;
+    mFrames[number % Capacity] = Frame{number, cpuSubmitTime, -1, swapBlockTime};
+    return number;
+}
+
+bool QMirClientFrameTimings::setGpuTime(quint64 frameNumber, qint64 gpuTime, Frame *frame)
+{
+    QMutexLocker lock(&mMutex);
+
+    // The result may have arrived after its slot got reused
+    Frame &slot = mFrames[frameNumber % Capacity];
+    if (frameNumber >= mFrameCount || slot.number != frameNumber) {
+        return false;
+    }
+
+    slot.gpuTime = gpuTime;
+    *frame = slot;
+    return true;
+}
+
+QVector<QMirClientFrameTimings::Frame> QMirClientFrameTimings::frames() const
+{
+    QMutexLocker lock(&mMutex);
+
+    const quint64 count = qMin<quint64>(mFrameCount, Capacity);
+    QVector<Frame> result;
+    result.reserve(count);
+    for (quint64 number = mFrameCount - count; number < mFrameCount; ++number) {
+        result.append(mFrames[number % Capacity]);
+    }
+    return result;
+}
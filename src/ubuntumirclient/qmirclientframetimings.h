@@ -0,0 +1,77 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QMIRCLIENTFRAMETIMINGS_H
+#define QMIRCLIENTFRAMETIMINGS_H
+
+#include <QMutex>
+#include <QVector>
+
+/*
+ * QMirClientFrameTimings - ring buffer of the most recent frame timings of a window.
+ *
+ * Written by the thread rendering the window, read by whoever asks through the native
+ * interface. GPU times arrive a few frames late as timer queries are never waited on.
+ */
+class QMirClientFrameTimings
+{
+public:
+    struct Frame {
+        quint64 number;
+        qint64 cpuSubmitTime;   // ns from the start of the frame to the swap request
+        qint64 gpuTime;         // ns spent by the GPU, -1 if unknown
+        qint64 swapBlockTime;   // ns spent blocked in eglSwapBuffers
+    };
+
+    enum { Capacity = 120 };
+
+    quint64 addFrame(qint64 cpuSubmitTime, qint64 swapBlockTime);
+    bool setGpuTime(quint64 frameNumber, qint64 gpuTime, Frame *frame);
+
+    // Oldest first
+    QVector<Frame> frames() const;
+
+private:
+    mutable QMutex mMutex;
+    Frame mFrames[Capacity];
+    quint64 mFrameCount{0};
+};
+
+#endif // QMIRCLIENTFRAMETIMINGS_H
@@ -39,6 +39,8 @@
 
 
 #include "qmirclientglcontext.h"
+#include "qmirclientextensions.h"
+#include "qmirclientframetimings.h"
 #include "qmirclientlogging.h"
 #include "qmirclientwindow.h"
 
@@ -51,6 +53,12 @@ Q_LOGGING_CATEGORY(mirclientGraphics, "qt.qpa.mirclient.graphics", QtWarningMsg)
 
 namespace {
 
+// From GL_EXT_disjoint_timer_query and GL_ARB_timer_query
+const GLenum TimeElapsed = 0x88BF;
+const GLenum QueryResult = 0x8866;
+const GLenum QueryResultAvailable = 0x8867;
+const GLenum GpuDisjoint = 0x8FBB;
+
 void printEglConfig(EGLDisplay display, EGLConfig config)
 {
     Q_ASSERT(display != EGL_NO_DISPLAY);
@@ -74,10 +82,70 @@ void printEglConfig(EGLDisplay display, EGLConfig config)
 QMirClientOpenGLContext::QMirClientOpenGLContext(const QSurfaceFormat &format, QPlatformOpenGLContext *share,
                                          EGLDisplay display)
     : QEGLPlatformContext(format, share, display, 0)
+    , mGpuTimingEnabled(!qEnvironmentVariableIsEmpty("QTUBUNTU_GPU_FRAME_TIMING"))
 {
     if (mirclientGraphics().isDebugEnabled()) {
         printEglConfig(display, eglConfig());
     }
+
+    mClock.start();
+}
+
+QMirClientOpenGLContext::~QMirClientOpenGLContext()
+{
+    const EGLDisplay display = eglDisplay();
+
+    // The timer queries belong to this context alone, it is made current without a window to delete them
+    if (mDeleteQueries && !mFrameTimers.isEmpty()) {
+        const EGLContext previousContext = eglGetCurrentContext();
+        const EGLSurface previousDrawSurface = eglGetCurrentSurface(EGL_DRAW);
+        const EGLSurface previousReadSurface = eglGetCurrentSurface(EGL_READ);
+
+        const EGLSurface surface = surfaceWithoutWindow();
+        if (eglMakeCurrent(display, surface, surface, eglContext())) {
+            for (auto it = mFrameTimers.begin(); it != mFrameTimers.end(); ++it) {
+                releaseFrameTimer(it.key(), it.value());
+            }
+            eglMakeCurrent(display, previousDrawSurface, previousReadSurface, previousContext);
+        }
+        mFrameTimers.clear();
+    }
+
+    if (mPbuffer != EGL_NO_SURFACE) {
+        eglDestroySurface(display, mPbuffer);
+    }
+}
+
+EGLSurface QMirClientOpenGLContext::surfaceWithoutWindow()
+{
+    const EGLDisplay display = eglDisplay();
+    if (mPbuffer == EGL_NO_SURFACE
+            && !qmirclientHasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")) {
+        const EGLint attributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        mPbuffer = eglCreatePbufferSurface(display, eglConfig(), attributes);
+    }
+    return mPbuffer;
+}
+
+// The GPU memory budget only destroys the EGL surface of a window out of sight once no context has it
+// current. As the threaded Qt Quick render loop never lets go of its window, the surface is dropped the
+// next time the rendering thread makes it current or swaps it: the context is made current without a
+// window, leaving the surface free to be destroyed.
+bool QMirClientOpenGLContext::releaseWindowSurface(QMirClientWindow *window)
+{
+    const EGLSurface surface = surfaceWithoutWindow();
+    if (!eglMakeCurrent(eglDisplay(), surface, surface, eglContext())) {
+        qCWarning(mirclientGraphics, "Failed to make the context current without a window (error 0x%x)", eglGetError());
+        return false;
+    }
+    qCDebug(mirclientGraphics, "releaseWindowSurface(window=%p) - releasing surface", window->window());
+
+    if (mCurrentWindow && mCurrentWindow != window) {
+        mCurrentWindow->eglSurfaceDoneCurrent();
+    }
+    window->eglSurfaceDoneCurrent();
+    mCurrentWindow = nullptr;
+    return true;
 }
 
 static bool needsFBOReadBackWorkaround()
@@ -98,6 +166,16 @@ static bool needsFBOReadBackWorkaround()
 
 bool QMirClientOpenGLContext::makeCurrent(QPlatformSurface* surface)
 {
+    QMirClientWindow *window = nullptr;
+    if (surface->surface()->surfaceClass() == QSurface::Window) {
+        window = static_cast<QMirClientWindow *>(surface);
+    }
+
+    // Nothing of a hidden window gets rendered, the context is only current to release resources
+    if (window && window->eglSurfaceReleasePending() && !window->isExposed()) {
+        return releaseWindowSurface(window);
+    }
+
     const bool ret = QEGLPlatformContext::makeCurrent(surface);
 
     if (Q_LIKELY(ret)) {
@@ -105,10 +183,183 @@ bool QMirClientOpenGLContext::makeCurrent(QPlatformSurface* surface)
         if (!ctx_d->workaround_brokenFBOReadBack && needsFBOReadBackWorkaround()) {
             ctx_d->workaround_brokenFBOReadBack = true;
         }
+
+        if (window) {
+            window->applyFrameRateCap(surface->format().swapInterval());
+            if (mGpuTimingEnabled) {
+                beginFrameTiming(window);
+            }
+        }
+
+        if (mCurrentWindow && mCurrentWindow != window) {
+            mCurrentWindow->eglSurfaceDoneCurrent();
+        }
+        mCurrentWindow = window;
+    } else if (window && window != mCurrentWindow) {
+        window->eglSurfaceDoneCurrent();
     }
     return ret;
 }
 
+void QMirClientOpenGLContext::doneCurrent()
+{
+    QEGLPlatformContext::doneCurrent();
+
+    if (mCurrentWindow) {
+        mCurrentWindow->eglSurfaceDoneCurrent();
+        mCurrentWindow = nullptr;
+    }
+}
+
+bool QMirClientOpenGLContext::resolveTimerQueryFunctions()
+{
+    if (mTimerQueryFunctionsResolved) {
+        return mGenQueries != nullptr;
+    }
+    mTimerQueryFunctionsResolved = true;
+
+    const char *extensions = reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS));
+    const char *suffix = nullptr;
+    if (format().renderableType() == QSurfaceFormat::OpenGLES) {
+        if (qmirclientHasExtension(extensions, "GL_EXT_disjoint_timer_query")) {
+            suffix = "EXT";
+            mHasDisjointTimerQuery = true;
+        }
+    } else if (qmirclientHasExtension(extensions, "GL_ARB_timer_query")) {
+        suffix = "";
+    }
+
+    if (!suffix) {
+        qCWarning(mirclientGraphics, "GPU frame timing requested, but timer queries are not supported");
+        return false;
+    }
+
+    auto resolve = [this, suffix](const char *name) {
+        return getProcAddress(QByteArray(name) + suffix);
+    };
+    mGenQueries = reinterpret_cast<GenQueriesFunction>(resolve("glGenQueries"));
+    mDeleteQueries = reinterpret_cast<DeleteQueriesFunction>(resolve("glDeleteQueries"));
+    mBeginQuery = reinterpret_cast<BeginQueryFunction>(resolve("glBeginQuery"));
+    mEndQuery = reinterpret_cast<EndQueryFunction>(resolve("glEndQuery"));
+    mGetQueryObjectiv = reinterpret_cast<GetQueryObjectivFunction>(resolve("glGetQueryObjectiv"));
+    mGetQueryObjectui64v = reinterpret_cast<GetQueryObjectui64vFunction>(resolve("glGetQueryObjectui64v"));
+
+    if (!mGenQueries || !mDeleteQueries || !mBeginQuery || !mEndQuery || !mGetQueryObjectiv || !mGetQueryObjectui64v) {
+        qCWarning(mirclientGraphics, "GPU frame timing requested, but timer query functions could not be resolved");
+        mGenQueries = nullptr;
+        mDeleteQueries = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+// Needs the context current. Ends the timer's query if active and deletes its query objects.
+void QMirClientOpenGLContext::releaseFrameTimer(QPlatformSurface *surface, FrameTimer &timer)
+{
+    if (mActiveQuerySurface == surface) {
+        mEndQuery(TimeElapsed);
+        mActiveQuerySurface = nullptr;
+    }
+    if (timer.queries[0] != 0) {
+        mDeleteQueries(TimerQueryCount, timer.queries);
+    }
+    timer = FrameTimer();
+}
+
+// Windows are destroyed in the GUI thread, their timers are dropped the next time the context is current
+void QMirClientOpenGLContext::releaseExpiredFrameTimers()
+{
+    for (auto it = mFrameTimers.begin(); it != mFrameTimers.end();) {
+        if (it->timings.isNull()) {
+            releaseFrameTimer(it.key(), it.value());
+            it = mFrameTimers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void QMirClientOpenGLContext::beginFrameTiming(QMirClientWindow *window)
+{
+    releaseExpiredFrameTimers();
+
+    FrameTimer &timer = mFrameTimers[window];
+
+    // A window may have been created at the address of a destroyed one not yet dropped
+    if (timer.timings != window->frameTimings()) {
+        releaseFrameTimer(window, timer);
+        timer.timings = window->frameTimings();
+    }
+
+    // makeCurrent may be called several times for a single frame
+    if (timer.frameStarted) {
+        return;
+    }
+    timer.frameStarted = true;
+    timer.frameStart = mClock.nsecsElapsed();
+
+    // Only one time elapsed query can be active at a time. If another window's frame never got
+    // swapped, e.g. because the window went away mid-frame, abandon its measurement.
+    if (mActiveQuerySurface && mActiveQuerySurface != window) {
+        mEndQuery(TimeElapsed);
+        auto it = mFrameTimers.find(mActiveQuerySurface);
+        if (it != mFrameTimers.end()) {
+            it->queryActive = false;
+            it->frameStarted = false;
+        }
+        mActiveQuerySurface = nullptr;
+    }
+
+    // Never wait for the GPU to hand back query objects, rather leave this frame untimed
+    if (timer.pendingCount == TimerQueryCount || !resolveTimerQueryFunctions()) {
+        return;
+    }
+
+    if (timer.queries[0] == 0) {
+        mGenQueries(TimerQueryCount, timer.queries);
+    }
+
+    const int index = (timer.pendingHead + timer.pendingCount) % TimerQueryCount;
+    mBeginQuery(TimeElapsed, timer.queries[index]);
+    timer.queryActive = true;
+    mActiveQuerySurface = window;
+}
+
+void QMirClientOpenGLContext::collectGpuTimings(QMirClientWindow *window, FrameTimer &timer)
+{
+    const QSharedPointer<QMirClientFrameTimings> timings = timer.timings.toStrongRef();
+
+    // Reading the disjoint state resets it. If set, the results at hand are meaningless.
+    GLint disjoint = GL_FALSE;
+    if (mHasDisjointTimerQuery) {
+        glGetIntegerv(GpuDisjoint, &disjoint);
+    }
+
+    while (timer.pendingCount > 0) {
+        const GLuint query = timer.queries[timer.pendingHead];
+
+        GLint available = GL_FALSE;
+        mGetQueryObjectiv(query, QueryResultAvailable, &available);
+        if (!available) {
+            break;
+        }
+
+        quint64 gpuTime = 0;
+        mGetQueryObjectui64v(query, QueryResult, &gpuTime);
+
+        QMirClientFrameTimings::Frame frame;
+        if (!disjoint && timings && timings->setGpuTime(timer.queryFrames[timer.pendingHead], gpuTime, &frame)) {
+            qCDebug(mirclientBufferSwap, "frameTiming(window=%p) [%llu] - cpu %lldus, gpu %lldus, swap %lldus",
+                    window->window(), frame.number, frame.cpuSubmitTime / 1000, frame.gpuTime / 1000,
+                    frame.swapBlockTime / 1000);
+        }
+
+        timer.pendingHead = (timer.pendingHead + 1) % TimerQueryCount;
+        --timer.pendingCount;
+    }
+}
+
 // Following method used internally in the base class QEGLPlatformContext to access
 // the egl surface of a QPlatformSurface/QMirClientWindow
 EGLSurface QMirClientOpenGLContext::eglSurfaceForPlatformSurface(QPlatformSurface *surface)
@@ -122,11 +373,59 @@ EGLSurface QMirClientOpenGLContext::eglSurfaceForPlatformSurface(QPlatformSurfac
 
 void QMirClientOpenGLContext::swapBuffers(QPlatformSurface *surface)
 {
-    QEGLPlatformContext::swapBuffers(surface);
+    if (surface->surface()->surfaceClass() != QSurface::Window) {
+        QEGLPlatformContext::swapBuffers(surface);
+        return;
+    }
 
-    if (surface->surface()->surfaceClass() == QSurface::Window) {
-        // notify window on swap completion
-        auto platformWindow = static_cast<QMirClientWindow *>(surface);
-        platformWindow->onSwapBuffersDone();
+    auto platformWindow = static_cast<QMirClientWindow *>(surface);
+
+    // Its surface got released as it was made current, there is nothing to swap
+    if (platformWindow != mCurrentWindow) {
+        return;
+    }
+
+    FrameTimer *timer = nullptr;
+    if (mGpuTimingEnabled) {
+        auto it = mFrameTimers.find(surface);
+        if (it != mFrameTimers.end() && it->frameStarted) {
+            timer = &it.value();
+        }
+    }
+
+    if (!timer) {
+        QEGLPlatformContext::swapBuffers(surface);
+    } else {
+        int queryIndex = -1;
+        if (timer->queryActive) {
+            mEndQuery(TimeElapsed);
+            queryIndex = (timer->pendingHead + timer->pendingCount) % TimerQueryCount;
+            timer->queryActive = false;
+            mActiveQuerySurface = nullptr;
+        }
+
+        const qint64 swapStart = mClock.nsecsElapsed();
+        QEGLPlatformContext::swapBuffers(surface);
+        const qint64 swapEnd = mClock.nsecsElapsed();
+
+        timer->frameStarted = false;
+        const quint64 frameNumber = platformWindow->frameTimings()->addFrame(swapStart - timer->frameStart, swapEnd - swapStart);
+
+        if (queryIndex >= 0) {
+            timer->queryFrames[queryIndex] = frameNumber;
+            ++timer->pendingCount;
+            collectGpuTimings(platformWindow, *timer);
+        } else {
+            qCDebug(mirclientBufferSwap, "frameTiming(window=%p) [%llu] - cpu %lldus, gpu not timed, swap %lldus",
+                    platformWindow->window(), frameNumber, (swapStart - timer->frameStart) / 1000,
+                    (swapEnd - swapStart) / 1000);
+        }
+    }
+
+    // notify window on swap completion
+    platformWindow->onSwapBuffersDone();
+
+    if (platformWindow->eglSurfaceReleasePending() && !platformWindow->isExposed()) {
+        releaseWindowSurface(platformWindow);
     }
 }
@@ -43,21 +43,82 @@
 
 #include <qpa/qplatformopenglcontext.h>
 #include <QtPlatformSupport/private/qeglplatformcontext_p.h>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QWeakPointer>
+#include <QtGui/qopenglfunctions.h>
 
 #include <EGL/egl.h>
 
+class QMirClientFrameTimings;
+class QMirClientWindow;
+
 class QMirClientOpenGLContext : public QEGLPlatformContext
 {
 public:
     QMirClientOpenGLContext(const QSurfaceFormat &format, QPlatformOpenGLContext *share,
                         EGLDisplay display);
+    ~QMirClientOpenGLContext();
 
     // QEGLPlatformContext methods.
     void swapBuffers(QPlatformSurface *surface) final;
     bool makeCurrent(QPlatformSurface *surface) final;
+    void doneCurrent() final;
 
 protected:
     EGLSurface eglSurfaceForPlatformSurface(QPlatformSurface *surface) final;
+
+private:
+    // GPU timing of each window's frames, using one timer query per frame. The timings are owned
+    // by the window, their expiry telling the window is gone.
+    enum { TimerQueryCount = 4 };
+    struct FrameTimer {
+        QWeakPointer<QMirClientFrameTimings> timings;
+        GLuint queries[TimerQueryCount]{};
+        quint64 queryFrames[TimerQueryCount]{};
+        int pendingHead{0};
+        int pendingCount{0};
+        bool queryActive{false};
+        bool frameStarted{false};
+        qint64 frameStart{0};
+    };
+
+    // EGL_NO_SURFACE if EGL supports surfaceless contexts, otherwise a pbuffer created on first use
+    EGLSurface surfaceWithoutWindow();
+    bool releaseWindowSurface(QMirClientWindow *window);
+
+    bool resolveTimerQueryFunctions();
+    void beginFrameTiming(QMirClientWindow *window);
+    void collectGpuTimings(QMirClientWindow *window, FrameTimer &timer);
+    void releaseFrameTimer(QPlatformSurface *surface, FrameTimer &timer);
+    void releaseExpiredFrameTimers();
+
+    typedef void (QOPENGLF_APIENTRYP GenQueriesFunction)(GLsizei n, GLuint *ids);
+    typedef void (QOPENGLF_APIENTRYP DeleteQueriesFunction)(GLsizei n, const GLuint *ids);
+    typedef void (QOPENGLF_APIENTRYP BeginQueryFunction)(GLenum target, GLuint id);
+    typedef void (QOPENGLF_APIENTRYP EndQueryFunction)(GLenum target);
+    typedef void (QOPENGLF_APIENTRYP GetQueryObjectivFunction)(GLuint id, GLenum pname, GLint *params);
+    typedef void (QOPENGLF_APIENTRYP GetQueryObjectui64vFunction)(GLuint id, GLenum pname, quint64 *params);
+
+    bool mGpuTimingEnabled;
+    bool mTimerQueryFunctionsResolved{false};
+    bool mHasDisjointTimerQuery{false};
+    GenQueriesFunction mGenQueries{nullptr};
+    DeleteQueriesFunction mDeleteQueries{nullptr};
+    BeginQueryFunction mBeginQuery{nullptr};
+    EndQueryFunction mEndQuery{nullptr};
+    GetQueryObjectivFunction mGetQueryObjectiv{nullptr};
+    GetQueryObjectui64vFunction mGetQueryObjectui64v{nullptr};
+
+    QElapsedTimer mClock;
+    QHash<QPlatformSurface *, FrameTimer> mFrameTimers;
+    QPlatformSurface *mActiveQuerySurface{nullptr};
+
+    // The window whose EGL surface is current, told once it no longer is
+    QPointer<QMirClientWindow> mCurrentWindow;
+    EGLSurface mPbuffer{EGL_NO_SURFACE};
 };
 
 #endif // QMIRCLIENTGLCONTEXT_H
@@ -0,0 +1,117 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmirclientgpumemorybudget.h"
+#include "qmirclientlogging.h"
+#include "qmirclientperfcounters.h"
+#include "qmirclientwindow.h"
+
+namespace {
+
+const int defaultBudget = 64; // MiB
+
+qint64 budgetFromEnvironment()
+{
+    bool ok;
+    int budget = qgetenv("QTUBUNTU_GPU_MEMORY_BUDGET").toInt(&ok);
+    if (!ok) {
+        budget = defaultBudget;
+    }
+    return budget < 0 ? -1 : qint64(budget) * 1024 * 1024;
+}
+
+} // anonymous namespace
+
+QMirClientGpuMemoryBudget::QMirClientGpuMemoryBudget()
+    : mBudget(budgetFromEnvironment())
+{
+}
+
+void QMirClientGpuMemoryBudget::addWindow(QMirClientWindow *window)
+{
+    mWindows.append(window);
+}
+
+void QMirClientGpuMemoryBudget::removeWindow(QMirClientWindow *window)
+{
+    mWindows.removeOne(window);
+    mHiddenWindows.removeOne(window);
+}
+
+void QMirClientGpuMemoryBudget::windowVisibilityChanged(QMirClientWindow *window, bool visible)
+{
+    if (mBudget < 0) {
+        return;
+    }
+
+    if (visible) {
+        mHiddenWindows.removeOne(window);
+        return;
+    }
+
+    // Windows keep their place from the moment they went out of sight
+    if (mHiddenWindows.contains(window)) {
+        return;
+    }
+    mHiddenWindows.append(window);
+    enforce();
+}
+
+void QMirClientGpuMemoryBudget::enforce()
+{
+    qint64 total = 0;
+    for (QMirClientWindow *window : mWindows) {
+        total += window->gpuMemoryUsage();
+    }
+
+    for (QMirClientWindow *window : mHiddenWindows) {
+        if (total <= mBudget) {
+            break;
+        }
+
+        const qint64 released = window->releaseGpuBuffers();
+        if (released > 0) {
+            qCDebug(mirclientGraphics, "Released the buffers of hidden window %p (%lld KiB), %lld KiB left in use",
+                    window->window(), released / 1024, (total - released) / 1024);
+            QMirClientPerfCounters::increment(QMirClientPerfCounters::WindowBuffersReleased);
+            total -= released;
+        }
+    }
+}
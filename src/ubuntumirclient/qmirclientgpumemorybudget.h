@@ -0,0 +1,77 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QMIRCLIENTGPUMEMORYBUDGET_H
+#define QMIRCLIENTGPUMEMORYBUDGET_H
+
+#include <QVector>
+
+class QMirClientWindow;
+
+/*
+ * QMirClientGpuMemoryBudget - caps the GPU memory held by the buffers of the process' windows.
+ *
+ * Windows nobody can see, being hidden or occluded, are the ones to give theirs up: once the
+ * estimated size of all window buffers exceeds the budget, those out of sight the longest
+ * release their EGL surface until back under budget. The surface gets recreated as soon as
+ * the window renders again.
+ *
+ * The budget is set in MiB with QTUBUNTU_GPU_MEMORY_BUDGET, 64 by default. 0 releases the
+ * buffers of every window as soon as it can't be seen, a negative value never does. Only
+ * used from the GUI thread.
+ */
+class QMirClientGpuMemoryBudget
+{
+public:
+    QMirClientGpuMemoryBudget();
+
+    void addWindow(QMirClientWindow *window);
+    void removeWindow(QMirClientWindow *window);
+    void windowVisibilityChanged(QMirClientWindow *window, bool visible);
+
+private:
+    void enforce();
+
+    qint64 mBudget; // bytes, negative if unlimited
+    QVector<QMirClientWindow *> mWindows;
+    QVector<QMirClientWindow *> mHiddenWindows; // least recently visible first
+};
+
+#endif // QMIRCLIENTGPUMEMORYBUDGET_H
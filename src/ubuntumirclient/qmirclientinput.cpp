@@ -40,8 +40,11 @@
 
 // Local
 #include "qmirclientinput.h"
+#include "qmirclientkeysym.h"
+#include "qmirclientflightrecorder.h"
 #include "qmirclientintegration.h"
 #include "qmirclientnativeinterface.h"
+#include "qmirclientperfcounters.h"
 #include "qmirclientscreen.h"
 #include "qmirclientwindow.h"
 #include "qmirclientlogging.h"
@@ -49,12 +52,12 @@
 
 // Qt
 #include <QtCore/QThread>
+#include <QtCore/QVarLengthArray>
 #include <QtCore/qglobal.h>
 #include <QtCore/QCoreApplication>
 #include <QtGui/private/qguiapplication_p.h>
 #include <qpa/qplatforminputcontext.h>
 #include <qpa/qwindowsysteminterface.h>
-#include <QTextCodec>
 
 #include <xkbcommon/xkbcommon.h>
 #include <xkbcommon/xkbcommon-keysyms.h>
@@ -66,106 +69,10 @@ Q_LOGGING_CATEGORY(mirclientInput, "qt.qpa.mirclient.input", QtWarningMsg)
 namespace
 {
 
-// XKB Keysyms which do not map directly to Qt types (i.e. Unicode points)
-static const uint32_t KeyTable[] = {
-    XKB_KEY_Escape,                  Qt::Key_Escape,
-    XKB_KEY_Tab,                     Qt::Key_Tab,
-    XKB_KEY_ISO_Left_Tab,            Qt::Key_Backtab,
-    XKB_KEY_BackSpace,               Qt::Key_Backspace,
-    XKB_KEY_Return,                  Qt::Key_Return,
-    XKB_KEY_Insert,                  Qt::Key_Insert,
-    XKB_KEY_Delete,                  Qt::Key_Delete,
-    XKB_KEY_Clear,                   Qt::Key_Delete,
-    XKB_KEY_Pause,                   Qt::Key_Pause,
-    XKB_KEY_Print,                   Qt::Key_Print,
-
-    XKB_KEY_Home,                    Qt::Key_Home,
-    XKB_KEY_End,                     Qt::Key_End,
-    XKB_KEY_Left,                    Qt::Key_Left,
-    XKB_KEY_Up,                      Qt::Key_Up,
-    XKB_KEY_Right,                   Qt::Key_Right,
-    XKB_KEY_Down,                    Qt::Key_Down,
-    XKB_KEY_Prior,                   Qt::Key_PageUp,
-    XKB_KEY_Next,                    Qt::Key_PageDown,
-
-    XKB_KEY_Shift_L,                 Qt::Key_Shift,
-    XKB_KEY_Shift_R,                 Qt::Key_Shift,
-    XKB_KEY_Shift_Lock,              Qt::Key_Shift,
-    XKB_KEY_Control_L,               Qt::Key_Control,
-    XKB_KEY_Control_R,               Qt::Key_Control,
-    XKB_KEY_Meta_L,                  Qt::Key_Meta,
-    XKB_KEY_Meta_R,                  Qt::Key_Meta,
-    XKB_KEY_Alt_L,                   Qt::Key_Alt,
-    XKB_KEY_Alt_R,                   Qt::Key_Alt,
-    XKB_KEY_Caps_Lock,               Qt::Key_CapsLock,
-    XKB_KEY_Num_Lock,                Qt::Key_NumLock,
-    XKB_KEY_Scroll_Lock,             Qt::Key_ScrollLock,
-    XKB_KEY_Super_L,                 Qt::Key_Super_L,
-    XKB_KEY_Super_R,                 Qt::Key_Super_R,
-    XKB_KEY_Menu,                    Qt::Key_Menu,
-    XKB_KEY_Hyper_L,                 Qt::Key_Hyper_L,
-    XKB_KEY_Hyper_R,                 Qt::Key_Hyper_R,
-    XKB_KEY_Help,                    Qt::Key_Help,
-
-    XKB_KEY_KP_Space,                Qt::Key_Space,
-    XKB_KEY_KP_Tab,                  Qt::Key_Tab,
-    XKB_KEY_KP_Enter,                Qt::Key_Enter,
-    XKB_KEY_KP_Home,                 Qt::Key_Home,
-    XKB_KEY_KP_Left,                 Qt::Key_Left,
-    XKB_KEY_KP_Up,                   Qt::Key_Up,
-    XKB_KEY_KP_Right,                Qt::Key_Right,
-    XKB_KEY_KP_Down,                 Qt::Key_Down,
-    XKB_KEY_KP_Prior,                Qt::Key_PageUp,
-    XKB_KEY_KP_Next,                 Qt::Key_PageDown,
-    XKB_KEY_KP_End,                  Qt::Key_End,
-    XKB_KEY_KP_Begin,                Qt::Key_Clear,
-    XKB_KEY_KP_Insert,               Qt::Key_Insert,
-    XKB_KEY_KP_Delete,               Qt::Key_Delete,
-    XKB_KEY_KP_Equal,                Qt::Key_Equal,
-    XKB_KEY_KP_Multiply,             Qt::Key_Asterisk,
-    XKB_KEY_KP_Add,                  Qt::Key_Plus,
-    XKB_KEY_KP_Separator,            Qt::Key_Comma,
-    XKB_KEY_KP_Subtract,             Qt::Key_Minus,
-    XKB_KEY_KP_Decimal,              Qt::Key_Period,
-    XKB_KEY_KP_Divide,               Qt::Key_Slash,
-
-    XKB_KEY_ISO_Level3_Shift,        Qt::Key_AltGr,
-    XKB_KEY_Multi_key,               Qt::Key_Multi_key,
-    XKB_KEY_Codeinput,               Qt::Key_Codeinput,
-    XKB_KEY_SingleCandidate,         Qt::Key_SingleCandidate,
-    XKB_KEY_MultipleCandidate,       Qt::Key_MultipleCandidate,
-    XKB_KEY_PreviousCandidate,       Qt::Key_PreviousCandidate,
-
-    // dead keys
-    XKB_KEY_dead_grave,              Qt::Key_Dead_Grave,
-    XKB_KEY_dead_acute,              Qt::Key_Dead_Acute,
-    XKB_KEY_dead_circumflex,         Qt::Key_Dead_Circumflex,
-    XKB_KEY_dead_tilde,              Qt::Key_Dead_Tilde,
-    XKB_KEY_dead_macron,             Qt::Key_Dead_Macron,
-    XKB_KEY_dead_breve,              Qt::Key_Dead_Breve,
-    XKB_KEY_dead_abovedot,           Qt::Key_Dead_Abovedot,
-    XKB_KEY_dead_diaeresis,          Qt::Key_Dead_Diaeresis,
-    XKB_KEY_dead_abovering,          Qt::Key_Dead_Abovering,
-    XKB_KEY_dead_doubleacute,        Qt::Key_Dead_Doubleacute,
-    XKB_KEY_dead_caron,              Qt::Key_Dead_Caron,
-    XKB_KEY_dead_cedilla,            Qt::Key_Dead_Cedilla,
-    XKB_KEY_dead_ogonek,             Qt::Key_Dead_Ogonek,
-    XKB_KEY_dead_iota,               Qt::Key_Dead_Iota,
-    XKB_KEY_dead_voiced_sound,       Qt::Key_Dead_Voiced_Sound,
-    XKB_KEY_dead_semivoiced_sound,   Qt::Key_Dead_Semivoiced_Sound,
-    XKB_KEY_dead_belowdot,           Qt::Key_Dead_Belowdot,
-    XKB_KEY_dead_hook,               Qt::Key_Dead_Hook,
-    XKB_KEY_dead_horn,               Qt::Key_Dead_Horn,
-
-    XKB_KEY_Mode_switch,             Qt::Key_Mode_switch,
-    XKB_KEY_script_switch,           Qt::Key_Mode_switch,
-    XKB_KEY_XF86AudioRaiseVolume,    Qt::Key_VolumeUp,
-    XKB_KEY_XF86AudioLowerVolume,    Qt::Key_VolumeDown,
-    XKB_KEY_XF86PowerOff,            Qt::Key_PowerOff,
-    XKB_KEY_XF86PowerDown,           Qt::Key_PowerDown,
-
-    0,                          0
-};
+// Touchpad scrolling, in fractions of wheel steps, also gets pixel deltas at this many pixels a step
+const int kPixelsPerScrollStep = 20;
+// Milliseconds without deltas after which a touchpad scroll ends
+const int kScrollEndTimeout = 100;
 
 Qt::WindowState mirWindowStateToQt(MirWindowState state)
 {
@@ -194,7 +101,8 @@ class UbuntuEvent : public QEvent
 {
 public:
     UbuntuEvent(QMirClientWindow* window, const MirEvent *event, QEvent::Type type)
-        : QEvent(type), window(window) {
+        : QEvent(type) {
+        targets.append(window);
         nativeEvent = mir_event_ref(event);
     }
     ~UbuntuEvent()
@@ -202,7 +110,8 @@ public:
         mir_event_unref(nativeEvent);
     }
 
-    QPointer<QMirClientWindow> window;
+    // The window the event is for, followed by the ones it is shared with
+    QVarLengthArray<QPointer<QMirClientWindow>, 4> targets;
     const MirEvent *nativeEvent;
 };
 
@@ -212,8 +121,20 @@ QMirClientInput::QMirClientInput(QMirClientClientIntegration* integration)
     , mEventFilterType(static_cast<QMirClientNativeInterface*>(
         integration->nativeInterface())->genericEventFilterType())
     , mEventType(static_cast<QEvent::Type>(QEvent::registerEventType()))
+    , mScrollFlushEventType(static_cast<QEvent::Type>(QEvent::registerEventType()))
     , mLastInputWindow(nullptr)
+    , mRawPointerWindow(nullptr)
+    , mKeyFastPath(!qEnvironmentVariableIsSet("QTUBUNTU_NO_KEY_FAST_PATH"))
+    , mInputContextComposing(false)
+    , mPendingScroll()
+    , mScrolling(false)
+    , mLastPointerButtons(Qt::NoButton)
 {
+    // Touchpads don't tell when a scroll ends, it does once they stop sending deltas
+    mScrollEndTimer.setSingleShot(true);
+    mScrollEndTimer.setInterval(kScrollEndTimeout);
+    connect(&mScrollEndTimer, &QTimer::timeout, this, &QMirClientInput::endScroll);
+
     // Initialize touch device.
     mTouchDevice = new QTouchDevice;
     mTouchDevice->setType(QTouchDevice::TouchScreen);
@@ -228,7 +149,7 @@ QMirClientInput::~QMirClientInput()
   // Qt will take care of deleting mTouchDevice.
 }
 
-static const char* nativeEventTypeToStr(MirEventType t)
+const char* qmirclientNativeEventTypeToStr(MirEventType t)
 {
     switch (t)
     {
@@ -265,10 +186,21 @@ static const char* nativeEventTypeToStr(MirEventType t)
 void QMirClientInput::customEvent(QEvent* event)
 {
     Q_ASSERT(QThread::currentThread() == thread());
+    if (event->type() == mScrollFlushEventType) {
+        mPendingScroll.flushPosted = false;
+        flushScroll();
+        return;
+    }
     UbuntuEvent* ubuntuEvent = static_cast<UbuntuEvent*>(event);
-    const MirEvent *nativeEvent = ubuntuEvent->nativeEvent;
 
-    if ((ubuntuEvent->window == nullptr) || (ubuntuEvent->window->window() == nullptr)) {
+    for (const auto &window : ubuntuEvent->targets) {
+        dispatchEvent(window, ubuntuEvent->nativeEvent);
+    }
+}
+
+void QMirClientInput::dispatchEvent(const QPointer<QMirClientWindow> &window, const MirEvent *nativeEvent)
+{
+    if ((window == nullptr) || (window->window() == nullptr)) {
         qCWarning(mirclient) << "Attempted to deliver an event to a non-existent window, ignoring.";
         return;
     }
@@ -276,26 +208,28 @@ void QMirClientInput::customEvent(QEvent* event)
     // Event filtering.
     long result;
     if (QWindowSystemInterface::handleNativeEvent(
-            ubuntuEvent->window->window(), mEventFilterType,
+            window->window(), mEventFilterType,
             const_cast<void *>(static_cast<const void *>(nativeEvent)), &result) == true) {
         qCDebug(mirclient, "event filtered out by native interface");
         return;
     }
 
-    qCDebug(mirclientInput, "customEvent(type=%s)", nativeEventTypeToStr(mir_event_get_type(nativeEvent)));
+    qCDebug(mirclientInput, "customEvent(type=%s)", qmirclientNativeEventTypeToStr(mir_event_get_type(nativeEvent)));
+    QMirClientFlightRecorder::record(QMirClientFlightRecorder::MirEventDispatched, window->window(),
+                                     mir_event_get_type(nativeEvent));
 
     // Event dispatching.
     switch (mir_event_get_type(nativeEvent))
     {
     case mir_event_type_input:
-        dispatchInputEvent(ubuntuEvent->window, mir_event_get_input_event(nativeEvent));
+        dispatchInputEvent(window, mir_event_get_input_event(nativeEvent));
         break;
     case mir_event_type_resize:
     {
         auto resizeEvent = mir_event_get_resize_event(nativeEvent);
 
         // Enable workaround for Screen rotation
-        auto const targetWindow = ubuntuEvent->window;
+        auto const targetWindow = window;
         if (targetWindow) {
             auto const screen = static_cast<QMirClientScreen*>(targetWindow->screen());
             if (screen) {
@@ -311,16 +245,19 @@ void QMirClientInput::customEvent(QEvent* event)
         break;
     }
     case mir_event_type_window:
-        handleWindowEvent(ubuntuEvent->window, mir_event_get_window_event(nativeEvent));
+        handleWindowEvent(window, mir_event_get_window_event(nativeEvent));
+        break;
+    case mir_event_type_window_placement:
+        window->invalidateScreenOrigin();
         break;
     case mir_event_type_window_output:
-        handleWindowOutputEvent(ubuntuEvent->window, mir_event_get_window_output_event(nativeEvent));
+        handleWindowOutputEvent(window, mir_event_get_window_output_event(nativeEvent));
         break;
     case mir_event_type_orientation:
-        dispatchOrientationEvent(ubuntuEvent->window->window(), mir_event_get_orientation_event(nativeEvent));
+        dispatchOrientationEvent(window->window(), mir_event_get_orientation_event(nativeEvent));
         break;
     case mir_event_type_close_window:
-        QWindowSystemInterface::handleCloseEvent(ubuntuEvent->window->window());
+        QWindowSystemInterface::handleCloseEvent(window->window());
         break;
     default:
         qCDebug(mirclient, "unhandled event type: %d", static_cast<int>(mir_event_get_type(nativeEvent)));
@@ -329,16 +266,22 @@ void QMirClientInput::customEvent(QEvent* event)
 
 void QMirClientInput::postEvent(QMirClientWindow *platformWindow, const MirEvent *event)
 {
-    QWindow *window = platformWindow->window();
+    QMirClientPerfCounters::eventReceived(mir_event_get_type(event));
 
-    QCoreApplication::postEvent(this, new UbuntuEvent(
-            platformWindow, event, mEventType));
+    auto ubuntuEvent = new UbuntuEvent(platformWindow, event, mEventType);
 
-    if ((window->flags().testFlag(Qt::WindowTransparentForInput)) && window->parent()) {
-        QCoreApplication::postEvent(this, new UbuntuEvent(
-                    static_cast<QMirClientWindow*>(platformWindow->QPlatformWindow::parent()),
-                    event, mEventType));
+    // Windows transparent for input share their events with their parent, and so on up the chain
+    QWindow *window = platformWindow->window();
+    while (window->flags().testFlag(Qt::WindowTransparentForInput) && window->parent()) {
+        platformWindow = static_cast<QMirClientWindow*>(platformWindow->QPlatformWindow::parent());
+        if (!platformWindow) {
+            break;
+        }
+        ubuntuEvent->targets.append(platformWindow);
+        window = platformWindow->window();
     }
+
+    QCoreApplication::postEvent(this, ubuntuEvent);
 }
 
 void QMirClientInput::dispatchInputEvent(QMirClientWindow *window, const MirInputEvent *ev)
@@ -359,78 +302,26 @@ void QMirClientInput::dispatchInputEvent(QMirClientWindow *window, const MirInpu
     }
 }
 
-void QMirClientInput::dispatchTouchEvent(QMirClientWindow *window, const MirInputEvent *ev)
+QMirClientTouchPoints &QMirClientInput::touchPoints(QMirClientWindow *window)
 {
-    const MirTouchEvent *tev = mir_input_event_get_touch_event(ev);
-
-    // FIXME(loicm) Max pressure is device specific. That one is for the Samsung Galaxy Nexus. That
-    //     needs to be fixed as soon as the compat input lib adds query support.
-    const float kMaxPressure = 1.28;
-    const QRect kWindowGeometry = window->geometry();
-    QList<QWindowSystemInterface::TouchPoint> touchPoints;
-
-
-    // TODO: Is it worth setting the Qt::TouchPointStationary ones? Currently they are left
-    //       as Qt::TouchPointMoved
-    const unsigned int kPointerCount = mir_touch_event_point_count(tev);
-    for (unsigned int i = 0; i < kPointerCount; ++i) {
-        QWindowSystemInterface::TouchPoint touchPoint;
-
-        const float kX = mir_touch_event_axis_value(tev, i, mir_touch_axis_x) + kWindowGeometry.x();
-        const float kY = mir_touch_event_axis_value(tev, i, mir_touch_axis_y) + kWindowGeometry.y(); // see bug lp:1346633 workaround comments elsewhere
-        const float kW = mir_touch_event_axis_value(tev, i, mir_touch_axis_touch_major);
-        const float kH = mir_touch_event_axis_value(tev, i, mir_touch_axis_touch_minor);
-        const float kP = mir_touch_event_axis_value(tev, i, mir_touch_axis_pressure);
-        touchPoint.id = mir_touch_event_id(tev, i);
-        touchPoint.normalPosition = QPointF(kX / kWindowGeometry.width(), kY / kWindowGeometry.height());
-        touchPoint.area = QRectF(kX - (kW / 2.0), kY - (kH / 2.0), kW, kH);
-        touchPoint.pressure = kP / kMaxPressure;
-
-        MirTouchAction touch_action = mir_touch_event_action(tev, i);
-        switch (touch_action)
-        {
-        case mir_touch_action_down:
-            mLastInputWindow = window;
-            touchPoint.state = Qt::TouchPointPressed;
-            break;
-        case mir_touch_action_up:
-            touchPoint.state = Qt::TouchPointReleased;
-            break;
-        case mir_touch_action_change:
-            touchPoint.state = Qt::TouchPointMoved;
-            break;
-        case mir_touch_actions:
-            Q_UNREACHABLE();
-        }
-
-        touchPoints.append(touchPoint);
+    auto it = mTouchPoints.find(window);
+    if (it == mTouchPoints.end()) {
+        connect(window, &QObject::destroyed, this, [this, window]() { mTouchPoints.remove(window); });
+        it = mTouchPoints.insert(window, QMirClientTouchPoints());
     }
-
-    ulong timestamp = mir_input_event_get_event_time(ev) / 1000000;
-    QWindowSystemInterface::handleTouchEvent(window->window(), timestamp,
-            mTouchDevice, touchPoints);
+    return it.value();
 }
 
-static uint32_t translateKeysym(uint32_t sym, const QString &text) {
-    int code = 0;
-
-    QTextCodec *systemCodec = QTextCodec::codecForLocale();
-    if (sym < 128 || (sym < 256 && systemCodec->mibEnum() == 4)) {
-        // upper-case key, if known
-        code = isprint((int)sym) ? toupper((int)sym) : 0;
-    } else if (sym >= XKB_KEY_F1 && sym <= XKB_KEY_F35) {
-        return Qt::Key_F1 + (int(sym) - XKB_KEY_F1);
-    } else if (text.length() == 1 && text.unicode()->unicode() > 0x1f
-               && text.unicode()->unicode() != 0x7f
-               && !(sym >= XKB_KEY_dead_grave && sym <= XKB_KEY_dead_currency)) {
-        code = text.unicode()->toUpper().unicode();
-    } else {
-        for (int i = 0; KeyTable[i]; i += 2)
-            if (sym == KeyTable[i])
-                code = KeyTable[i + 1];
+void QMirClientInput::dispatchTouchEvent(QMirClientWindow *window, const MirInputEvent *ev)
+{
+    QMirClientTouchPoints &touchPoints = this->touchPoints(window);
+    if (touchPoints.update(ev, window->geometry())) {
+        mLastInputWindow = window;
     }
 
-    return code;
+    ulong timestamp = mir_input_event_get_event_time(ev) / 1000000;
+    QWindowSystemInterface::handleTouchEvent(window->window(), timestamp,
+            mTouchDevice, touchPoints.points());
 }
 
 namespace
@@ -457,6 +348,15 @@ Qt::KeyboardModifiers qt_modifiers_from_mir(MirInputEventModifiers modifiers)
 }
 }
 
+// Dead keys, the compose key and the input method keys (Kanji, Henkan, Hangul...) start compositions,
+// while input methods bind their shortcuts to modified keys.
+static bool mayStartComposition(xkb_keysym_t sym, Qt::KeyboardModifiers modifiers)
+{
+    return (sym >= XKB_KEY_dead_grave && sym <= XKB_KEY_dead_greek)
+        || (sym >= XKB_KEY_Multi_key && sym <= XKB_KEY_Hangul_Special)
+        || (modifiers & ~(Qt::ShiftModifier | Qt::KeypadModifier));
+}
+
 void QMirClientInput::dispatchKeyEvent(QMirClientWindow *window, const MirInputEvent *event)
 {
     const MirKeyboardEvent *key_event = mir_input_event_get_keyboard_event(event);
@@ -476,24 +376,26 @@ void QMirClientInput::dispatchKeyEvent(QMirClientWindow *window, const MirInputE
     if (action == mir_keyboard_action_down)
         mLastInputWindow = window;
 
-    QString text;
-    QVarLengthArray<char, 32> chars(32);
-    {
-        int result = xkb_keysym_to_utf8(xk_sym, chars.data(), chars.size());
-
-        if (result > 0) {
-            text = QString::fromUtf8(chars.constData());
-        }
-    }
-    int sym = translateKeysym(xk_sym, text);
+    const QString text = qmirclientKeysymText(xk_sym);
+    int sym = qmirclientTranslateKeysym(xk_sym, text);
 
     bool is_auto_rep = action == mir_keyboard_action_repeat;
 
+    // Filtering keys can be a round trip to the input method. Keys typed on a hardware keyboard
+    // skip it while the on-screen keyboard is hidden, the input method let the last key press it
+    // saw through (so isn't composing) and the key can't start a composition. Releases don't tell,
+    // the release of a dead key being let through while the composition goes on.
     QPlatformInputContext *context = QGuiApplicationPrivate::platformIntegration()->inputContext();
-    if (context) {
+    const bool inputContextIdle = mKeyFastPath && !mInputContextComposing && context
+        && !context->isInputPanelVisible() && !mayStartComposition(xk_sym, modifiers);
+    if (context && !inputContextIdle) {
         QKeyEvent qKeyEvent(keyType, sym, modifiers, scan_code, xk_sym, native_modifiers, text, is_auto_rep);
         qKeyEvent.setTimestamp(timestamp);
-        if (context->filterEvent(&qKeyEvent)) {
+        const bool filtered = context->filterEvent(&qKeyEvent);
+        if (keyType == QEvent::KeyPress) {
+            mInputContextComposing = filtered;
+        }
+        if (filtered) {
             qCDebug(mirclient, "key event filtered out by input context");
             return;
         }
@@ -531,11 +433,26 @@ void QMirClientInput::dispatchPointerEvent(QMirClientWindow *platformWindow, con
     const auto action = mir_pointer_event_action(pev);
 
     const auto modifiers = qt_modifiers_from_mir(mir_pointer_event_modifiers(pev));
-    const auto localPoint = QPointF(mir_pointer_event_axis_value(pev, mir_pointer_axis_x),
-                                    mir_pointer_event_axis_value(pev, mir_pointer_axis_y));
+    auto localPoint = QPointF(mir_pointer_event_axis_value(pev, mir_pointer_axis_x),
+                              mir_pointer_event_axis_value(pev, mir_pointer_axis_y));
+    auto globalPoint = window->position() + localPoint;
 
     mLastInputWindow = platformWindow;
 
+    // Raw pointer windows get the unaccelerated device motion, accumulated into an unbounded position
+    // starting where the pointer was. Applications take the deltas between successive mouse events.
+    if (platformWindow->rawPointer()) {
+        if (mRawPointerWindow != platformWindow) {
+            mRawPointerWindow = platformWindow;
+            mRawPointerPosition = localPoint;
+        }
+        mRawPointerPosition += QPointF(mir_pointer_event_axis_value(pev, mir_pointer_axis_relative_x),
+                                       mir_pointer_event_axis_value(pev, mir_pointer_axis_relative_y));
+        localPoint = globalPoint = mRawPointerPosition;
+    } else if (mRawPointerWindow == platformWindow) {
+        mRawPointerWindow = nullptr;
+    }
+
     switch (action) {
     case mir_pointer_action_button_up:
     case mir_pointer_action_button_down:
@@ -543,22 +460,33 @@ void QMirClientInput::dispatchPointerEvent(QMirClientWindow *platformWindow, con
     {
         const float hDelta = mir_pointer_event_axis_value(pev, mir_pointer_axis_hscroll);
         const float vDelta = mir_pointer_event_axis_value(pev, mir_pointer_axis_vscroll);
+        auto buttons = extract_buttons(pev);
 
         if (hDelta != 0 || vDelta != 0) {
-            // QWheelEvent::DefaultDeltasPerStep = 120 but doesn't exist on vivid
-            const QPoint angleDelta(120 * hDelta, 120 * vDelta);
-            QWindowSystemInterface::handleWheelEvent(window, timestamp, localPoint, window->position() + localPoint,
-                                                     QPoint(), angleDelta, modifiers, Qt::ScrollUpdate);
+            queueScroll(platformWindow, timestamp, localPoint, globalPoint, modifiers, QPointF(hDelta, vDelta));
+
+            // Scroll-only events repeat the pointer position and buttons, which Qt already has
+            if (action == mir_pointer_action_motion && mLastPointerWindow == platformWindow
+                    && mLastPointerPoint == localPoint && mLastPointerButtons == buttons) {
+                break;
+            }
         }
-        auto buttons = extract_buttons(pev);
-        QWindowSystemInterface::handleMouseEvent(window, timestamp, localPoint, window->position() + localPoint /* Should we omit global point instead? */,
+
+        // Keep the pending scroll in order with the pointer's other events
+        flushScroll();
+        mLastPointerWindow = platformWindow;
+        mLastPointerPoint = localPoint;
+        mLastPointerButtons = buttons;
+        QWindowSystemInterface::handleMouseEvent(window, timestamp, localPoint, globalPoint /* Should we omit global point instead? */,
                                                  buttons, modifiers);
         break;
     }
     case mir_pointer_action_enter:
-        QWindowSystemInterface::handleEnterEvent(window, localPoint, window->position() + localPoint);
+        QWindowSystemInterface::handleEnterEvent(window, localPoint, globalPoint);
         break;
     case mir_pointer_action_leave:
+        flushScroll();
+        mLastPointerWindow.clear();
         QWindowSystemInterface::handleLeaveEvent(window);
         break;
     case mir_pointer_actions:
@@ -566,6 +494,87 @@ void QMirClientInput::dispatchPointerEvent(QMirClientWindow *platformWindow, con
     }
 }
 
+// Scroll deltas are accumulated while input events are queued, and sent as one wheel event once they
+// have all been dispatched. Wheels scroll by whole steps, touchpads by fractions of them for which pixel
+// deltas are sent too. The fractions of 120th of step and of pixel are carried to the next wheel event.
+// A scroll sequence ends when the window or the modifiers change, or when a touchpad starts scrolling. A
+// touchpad sequence stays continuous even when some of its deltas are whole steps.
+void QMirClientInput::queueScroll(QMirClientWindow *window, ulong timestamp, const QPointF &localPoint,
+                                  const QPointF &globalPoint, Qt::KeyboardModifiers modifiers, const QPointF &steps)
+{
+    const bool continuous = steps.x() != qRound(steps.x()) || steps.y() != qRound(steps.y());
+    if (mPendingScroll.window != window || mPendingScroll.modifiers != modifiers
+            || (continuous && !mPendingScroll.continuous)) {
+        endScroll();
+    }
+
+    mPendingScroll.window = window;
+    mPendingScroll.timestamp = timestamp;
+    mPendingScroll.localPoint = localPoint;
+    mPendingScroll.globalPoint = globalPoint;
+    mPendingScroll.modifiers = modifiers;
+    mPendingScroll.steps += steps;
+    mPendingScroll.continuous = mPendingScroll.continuous || continuous;
+
+    if (!mPendingScroll.flushPosted) {
+        mPendingScroll.flushPosted = true;
+        QCoreApplication::postEvent(this, new QEvent(mScrollFlushEventType), Qt::LowEventPriority);
+    } else {
+        QMirClientPerfCounters::increment(QMirClientPerfCounters::WheelEventsCoalesced);
+    }
+}
+
+void QMirClientInput::flushScroll()
+{
+    if (mPendingScroll.steps.isNull()) {
+        return;
+    }
+
+    const QPointer<QMirClientWindow> platformWindow = mPendingScroll.window;
+    const QPointF steps = mPendingScroll.steps;
+    mPendingScroll.steps = QPointF();
+    if (!platformWindow) {
+        return;
+    }
+
+    // QWheelEvent::DefaultDeltasPerStep = 120 but doesn't exist on vivid
+    const QPointF angle = steps * 120 + mAngleDeltaRemainder;
+    const QPoint angleDelta(static_cast<int>(angle.x()), static_cast<int>(angle.y()));
+    mAngleDeltaRemainder = angle - angleDelta;
+
+    QPoint pixelDelta;
+    Qt::ScrollPhase phase = Qt::ScrollUpdate;
+    if (mPendingScroll.continuous) {
+        const QPointF pixels = steps * kPixelsPerScrollStep + mPixelDeltaRemainder;
+        pixelDelta = QPoint(static_cast<int>(pixels.x()), static_cast<int>(pixels.y()));
+        mPixelDeltaRemainder = pixels - pixelDelta;
+
+        phase = mScrolling ? Qt::ScrollUpdate : Qt::ScrollBegin;
+        mScrolling = true;
+        mScrollEndTimer.start();
+    }
+
+    QWindowSystemInterface::handleWheelEvent(platformWindow->window(), mPendingScroll.timestamp,
+                                             mPendingScroll.localPoint, mPendingScroll.globalPoint,
+                                             pixelDelta, angleDelta, mPendingScroll.modifiers, phase);
+}
+
+void QMirClientInput::endScroll()
+{
+    mScrollEndTimer.stop();
+    flushScroll();
+
+    if (mScrolling && mPendingScroll.window) {
+        QWindowSystemInterface::handleWheelEvent(mPendingScroll.window->window(), mPendingScroll.timestamp,
+                                                 mPendingScroll.localPoint, mPendingScroll.globalPoint,
+                                                 QPoint(), QPoint(), mPendingScroll.modifiers, Qt::ScrollEnd);
+    }
+    mScrolling = false;
+    mPendingScroll.continuous = false;
+    mAngleDeltaRemainder = QPointF();
+    mPixelDeltaRemainder = QPointF();
+}
+
 static const char* nativeOrientationDirectionToStr(MirOrientation orientation)
 {
     switch (orientation) {
@@ -622,6 +631,8 @@ void QMirClientInput::handleWindowEvent(const QPointer<QMirClientWindow> &window
 {
     auto windowEventAttribute = mir_window_event_get_attribute(event);
 
+    window->invalidateScreenOrigin();
+
     switch (windowEventAttribute) {
     case mir_window_attrib_focus: {
         window->handleSurfaceFocusChanged(
@@ -43,12 +43,19 @@
 
 // Qt
 #include <qpa/qwindowsysteminterface.h>
+#include <QHash>
+#include <QPointer>
+#include <QTimer>
 
 #include <mir_toolkit/mir_client_library.h>
 
+#include "qmirclienttouchpoints.h"
+
 class QMirClientClientIntegration;
 class QMirClientWindow;
 
+const char* qmirclientNativeEventTypeToStr(MirEventType t);
+
 class QMirClientInput : public QObject
 {
     Q_OBJECT
@@ -68,6 +75,7 @@ protected:
     void dispatchKeyEvent(QMirClientWindow *window, const MirInputEvent *event);
     void dispatchPointerEvent(QMirClientWindow *window, const MirInputEvent *event);
     void dispatchTouchEvent(QMirClientWindow *window, const MirInputEvent *event);
+    void dispatchEvent(const QPointer<QMirClientWindow> &window, const MirEvent *event);
     void dispatchInputEvent(QMirClientWindow *window, const MirInputEvent *event);
 
     void dispatchOrientationEvent(QWindow* window, const MirOrientationEvent *event);
@@ -75,12 +83,45 @@ protected:
     void handleWindowOutputEvent(const QPointer<QMirClientWindow> &window, const MirWindowOutputEvent *event);
 
 private:
+    // Reused from one touch event of a window to the next, the steady state allocating nothing
+    QMirClientTouchPoints &touchPoints(QMirClientWindow *window);
+
+    // Scroll deltas pending until the queued input events are dispatched, in wheel steps
+    struct PendingScroll {
+        QPointer<QMirClientWindow> window;
+        ulong timestamp;
+        QPointF localPoint;
+        QPointF globalPoint;
+        Qt::KeyboardModifiers modifiers;
+        QPointF steps;
+        bool continuous; // of the whole sequence, until endScroll()
+        bool flushPosted;
+    };
+    void queueScroll(QMirClientWindow *window, ulong timestamp, const QPointF &localPoint,
+                     const QPointF &globalPoint, Qt::KeyboardModifiers modifiers, const QPointF &steps);
+    void flushScroll();
+    void endScroll();
+
     QMirClientClientIntegration* mIntegration;
     QTouchDevice* mTouchDevice;
     const QByteArray mEventFilterType;
     const QEvent::Type mEventType;
+    const QEvent::Type mScrollFlushEventType;
 
     QMirClientWindow *mLastInputWindow;
+    QPointF mRawPointerPosition;
+    QMirClientWindow *mRawPointerWindow;
+    const bool mKeyFastPath;
+    bool mInputContextComposing;
+    QHash<QMirClientWindow*, QMirClientTouchPoints> mTouchPoints;
+    PendingScroll mPendingScroll;
+    QPointF mAngleDeltaRemainder;
+    QPointF mPixelDeltaRemainder;
+    bool mScrolling;
+    QTimer mScrollEndTimer;
+    QPointer<QMirClientWindow> mLastPointerWindow;
+    QPointF mLastPointerPoint;
+    Qt::MouseButtons mLastPointerButtons;
 };
 
 #endif // QMIRCLIENTINPUT_H
@@ -44,11 +44,18 @@
 #include "qmirclientclipboard.h"
 #include "qmirclientdebugextension.h"
 #include "qmirclientdesktopwindow.h"
+#include "qmirclientflightrecorder.h"
+#include "qmirclientframeratepolicy.h"
 #include "qmirclientglcontext.h"
+#include "qmirclientgpumemorybudget.h"
 #include "qmirclientinput.h"
 #include "qmirclientlogging.h"
 #include "qmirclientnativeinterface.h"
+#include "qmirclientperfcounters.h"
+#include "qmirclientprogrambinarycache.h"
 #include "qmirclientscreen.h"
+#include "qmirclientstatearchive.h"
+#include "qmirclientstartuptrace.h"
 #include "qmirclientwindow.h"
 #include "../shared/ubuntutheme.h"
 
@@ -66,6 +73,8 @@
 #include <QOpenGLContext>
 #include <QOffscreenSurface>
 
+#include <fontconfig/fontconfig.h>
+
 // platform-api
 #include <ubuntu/application/lifecycle_delegate.h>
 #include <ubuntu/application/id.h>
@@ -87,6 +96,10 @@ static void aboutToStopCallback(UApplicationArchive */*archive*/, void *context)
         qCWarning(mirclient) << "aboutToStopCallback(): no input context";
     }
     integration->appStateController()->setSuspended();
+
+    // The platform-api archive goes nowhere, the plugin keeps its own for the next run should
+    // the application get killed while suspended
+    integration->stateArchive()->save();
 }
 
 
@@ -94,12 +107,30 @@ QMirClientClientIntegration::QMirClientClientIntegration(int argc, char **argv)
     : QPlatformIntegration()
     , mNativeInterface(new QMirClientNativeInterface(this))
     , mFontDb(new QGenericUnixFontDatabase)
+    , mFontconfigInitThread([]() {
+        // Loading the fontconfig configuration and caches is the bulk of populating the font
+        // database, get it done while we connect to Mir. Joined in fontDatabase().
+        QMirClientStartupTrace::Phase tracePhase("fontconfigInit");
+        FcInit();
+    })
     , mServices(new QMirClientPlatformServices)
     , mAppStateController(new QMirClientAppStateController)
+    , mGpuMemoryBudget(new QMirClientGpuMemoryBudget)
+    , mFrameRatePolicy(new QMirClientFrameRatePolicy(mAppStateController.data()))
+    , mProgramBinaryCache(new QMirClientProgramBinaryCache)
+    , mStateArchive(new QMirClientStateArchive)
     , mScaleFactor(1.0)
 {
+    QMirClientStartupTrace::Phase tracePhase("QMirClientClientIntegration");
+    QMirClientStartupTrace::setCompositorRoundTrips([]() {
+        return QMirClientPerfCounters::value(QMirClientPerfCounters::CompositorRoundTrips);
+    });
+
+    QMirClientFlightRecorder::installSignalHandler();
+
     QByteArray sessionName;
     {
+        QMirClientStartupTrace::Phase tracePhase("setupOptions");
         QStringList args = QCoreApplication::arguments();
         setupOptions(args);
         sessionName = generateSessionName(args);
@@ -107,7 +138,11 @@ QMirClientClientIntegration::QMirClientClientIntegration(int argc, char **argv)
     }
 
     // Create new application instance
-    mInstance = u_application_instance_new_from_description_with_options(mDesc, mOptions);
+    {
+        QMirClientStartupTrace::Phase tracePhase("connect");
+        mInstance = u_application_instance_new_from_description_with_options(mDesc, mOptions);
+        QMirClientPerfCounters::increment(QMirClientPerfCounters::CompositorRoundTrips);
+    }
 
     if (mInstance == nullptr) {
         qCritical("[QPA] QMirClientClientIntegration: connection to Mir server failed.\n");
@@ -129,10 +164,13 @@ QMirClientClientIntegration::QMirClientClientIntegration(int argc, char **argv)
     defaultFormat.setBlueBufferSize(8);
     QSurfaceFormat::setDefaultFormat(defaultFormat);
 
-    // Initialize EGL.
+    // Initialize EGL in the background, it only gets used once windows or GL contexts are created.
     mEglNativeDisplay = mir_connection_get_egl_native_display(mMirConnection);
     ASSERT((mEglDisplay = eglGetDisplay(mEglNativeDisplay)) != EGL_NO_DISPLAY);
-    ASSERT(eglInitialize(mEglDisplay, nullptr, nullptr) == EGL_TRUE);
+    mEglInitializeThread = std::thread([this]() {
+        QMirClientStartupTrace::Phase tracePhase("eglInitialize");
+        mEglInitialized = eglInitialize(mEglDisplay, nullptr, nullptr);
+    });
 
     // Has debug mode been requsted, either with "-testability" switch or QT_LOAD_TESTABILITY env var
     bool testability = qEnvironmentVariableIsSet("QT_LOAD_TESTABILITY");
@@ -142,6 +180,7 @@ QMirClientClientIntegration::QMirClientClientIntegration(int argc, char **argv)
         }
     }
     if (testability) {
+        QMirClientStartupTrace::Phase tracePhase("debugExtension");
         mDebugExtension.reset(new QMirClientDebugExtension(mMirConnection));
         if (!mDebugExtension->isEnabled()) {
             mDebugExtension.reset();
@@ -151,20 +190,28 @@ QMirClientClientIntegration::QMirClientClientIntegration(int argc, char **argv)
 
 void QMirClientClientIntegration::initialize()
 {
+    QMirClientStartupTrace::Phase tracePhase("initialize");
+
     // Init the ScreenObserver
-    mScreenObserver.reset(new QMirClientScreenObserver(mMirConnection));
-    connect(mScreenObserver.data(), &QMirClientScreenObserver::screenAdded,
-            [this](QMirClientScreen *screen) { this->screenAdded(screen); });
-    connect(mScreenObserver.data(), &QMirClientScreenObserver::screenRemoved,
-                     this, &QMirClientClientIntegration::destroyScreen);
-
-    Q_FOREACH (auto screen, mScreenObserver->screens()) {
-        screenAdded(screen);
+    {
+        QMirClientStartupTrace::Phase tracePhase("screenObserver");
+        mScreenObserver.reset(new QMirClientScreenObserver(mMirConnection));
+        connect(mScreenObserver.data(), &QMirClientScreenObserver::screenAdded,
+                [this](QMirClientScreen *screen) { this->screenAdded(screen); });
+        connect(mScreenObserver.data(), &QMirClientScreenObserver::screenRemoved,
+                         this, &QMirClientClientIntegration::destroyScreen);
+
+        Q_FOREACH (auto screen, mScreenObserver->screens()) {
+            screenAdded(screen);
+        }
     }
 
     // Initialize input.
     mInput = new QMirClientInput(this);
-    mInputContext = QPlatformInputContextFactory::create();
+    {
+        QMirClientStartupTrace::Phase tracePhase("inputContext");
+        mInputContext = QPlatformInputContextFactory::create();
+    }
 
     // compute the scale factor
     const int defaultGridUnit = 8;
@@ -178,16 +225,46 @@ void QMirClientClientIntegration::initialize()
         }
     }
     mScaleFactor = static_cast<qreal>(gridUnit) / defaultGridUnit;
+
+    QMirClientPerfCounters::startPeriodicDump(this);
 }
 
 QMirClientClientIntegration::~QMirClientClientIntegration()
 {
-    eglTerminate(mEglDisplay);
+    QMirClientStartupTrace::finish();
+    // Exiting normally, the next run starts afresh
+    mStateArchive->discard();
+    fontDatabase();
+    eglTerminate(eglDisplay());
     delete mInput;
     delete mInputContext;
     delete mServices;
 }
 
+QPlatformFontDatabase *QMirClientClientIntegration::fontDatabase() const
+{
+    std::call_once(mFontconfigInitJoined, [this]() {
+        QMirClientStartupTrace::Phase tracePhase("waitForFontconfigInit");
+        mFontconfigInitThread.join();
+    });
+    return mFontDb;
+}
+
+EGLDisplay QMirClientClientIntegration::eglDisplay() const
+{
+    waitForEglInitialize();
+    return mEglDisplay;
+}
+
+void QMirClientClientIntegration::waitForEglInitialize() const
+{
+    std::call_once(mEglInitializeJoined, [this]() {
+        QMirClientStartupTrace::Phase tracePhase("waitForEglInitialize");
+        mEglInitializeThread.join();
+        ASSERT(mEglInitialized == EGL_TRUE);
+    });
+}
+
 QPlatformServices *QMirClientClientIntegration::services() const
 {
     return mServices;
@@ -257,8 +334,9 @@ QPlatformWindow* QMirClientClientIntegration::createPlatformWindow(QWindow* wind
         // Desktop windows should not be backed up by a mir surface as they don't draw anything (nor should).
         return new QMirClientDesktopWindow(window);
     } else {
+        QMirClientStartupTrace::Phase tracePhase("createPlatformWindow");
         return new QMirClientWindow(window, mInput, mNativeInterface, mAppStateController.data(),
-                                    mEglDisplay, mMirConnection, mDebugExtension.data());
+                                    mGpuMemoryBudget.data(), mFrameRatePolicy.data(), eglDisplay(), mMirConnection, mDebugExtension.data());
     }
 }
 
@@ -303,6 +381,7 @@ QPlatformOpenGLContext* QMirClientClientIntegration::createPlatformOpenGLContext
 {
     QSurfaceFormat format(context->format());
 
+    waitForEglInitialize();
     auto platformContext = new QMirClientOpenGLContext(format, context->shareHandle(), mEglDisplay);
     if (!platformContext->isValid()) {
         // Older Intel Atom-based devices only support OpenGL 1.4 compatibility profile but by default
@@ -354,6 +433,7 @@ QPlatformClipboard* QMirClientClientIntegration::clipboard() const
 {
     static QPlatformClipboard *clipboard = nullptr;
     if (!clipboard) {
+        QMirClientStartupTrace::Phase tracePhase("clipboard");
         clipboard = new QMirClientClipboard;
     }
     return clipboard;
@@ -367,7 +447,7 @@ QPlatformNativeInterface* QMirClientClientIntegration::nativeInterface() const
 QPlatformOffscreenSurface *QMirClientClientIntegration::createPlatformOffscreenSurface(
         QOffscreenSurface *surface) const
 {
-    return new QEGLPbuffer(mEglDisplay, surface->requestedFormat(), surface);
+    return new QEGLPbuffer(eglDisplay(), surface->requestedFormat(), surface);
 }
 
 void QMirClientClientIntegration::destroyScreen(QMirClientScreen *screen)
@@ -404,6 +484,7 @@ void QMirClientClientIntegration::destroyScreen(QMirClientScreen *screen)
 QPlatformAccessibility *QMirClientClientIntegration::accessibility() const
 {
     if (!mAccessibility) {
+        QMirClientStartupTrace::Phase tracePhase("accessibility");
         mAccessibility.reset(new QSpiAccessibleBridge());
     }
     return mAccessibility.data();
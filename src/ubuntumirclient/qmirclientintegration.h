@@ -54,10 +54,17 @@
 
 #include <EGL/egl.h>
 
+#include <mutex>
+#include <thread>
+
 class QMirClientDebugExtension;
+class QMirClientFrameRatePolicy;
+class QMirClientGpuMemoryBudget;
 class QMirClientInput;
 class QMirClientNativeInterface;
+class QMirClientProgramBinaryCache;
 class QMirClientScreen;
+class QMirClientStateArchive;
 struct MirConnection;
 
 class QMirClientClientIntegration : public QObject, public QPlatformIntegration
@@ -74,7 +81,7 @@ public:
     QPlatformNativeInterface* nativeInterface() const override;
     QPlatformBackingStore* createPlatformBackingStore(QWindow* window) const override;
     QPlatformOpenGLContext* createPlatformOpenGLContext(QOpenGLContext* context) const override;
-    QPlatformFontDatabase* fontDatabase() const override { return mFontDb; }
+    QPlatformFontDatabase* fontDatabase() const override;
     QStringList themeNames() const override;
     QPlatformTheme* createPlatformTheme(const QString& name) const override;
     QVariant styleHint(StyleHint hint) const override;
@@ -88,11 +95,13 @@ public:
 
     // New methods.
     MirConnection *mirConnection() const { return mMirConnection; }
-    EGLDisplay eglDisplay() const { return mEglDisplay; }
+    EGLDisplay eglDisplay() const;
     EGLNativeDisplayType eglNativeDisplay() const { return mEglNativeDisplay; }
     QMirClientAppStateController *appStateController() const { return mAppStateController.data(); }
     QMirClientScreenObserver *screenObserver() const { return mScreenObserver.data(); }
     QMirClientDebugExtension *debugExtension() const { return mDebugExtension.data(); }
+    QMirClientProgramBinaryCache *programBinaryCache() const { return mProgramBinaryCache.data(); }
+    QMirClientStateArchive *stateArchive() const { return mStateArchive.data(); }
 
 private Q_SLOTS:
     void destroyScreen(QMirClientScreen *screen);
@@ -102,9 +111,12 @@ private:
     void setupDescription(QByteArray &sessionName);
     static QByteArray generateSessionName(QStringList &args);
     static QByteArray generateSessionNameFromQmlFile(QStringList &args);
+    void waitForEglInitialize() const;
 
     QMirClientNativeInterface* mNativeInterface;
     QPlatformFontDatabase* mFontDb;
+    mutable std::thread mFontconfigInitThread;
+    mutable std::once_flag mFontconfigInitJoined;
 
     QMirClientPlatformServices* mServices;
 
@@ -114,6 +126,10 @@ private:
     QScopedPointer<QMirClientDebugExtension> mDebugExtension;
     QScopedPointer<QMirClientScreenObserver> mScreenObserver;
     QScopedPointer<QMirClientAppStateController> mAppStateController;
+    QScopedPointer<QMirClientGpuMemoryBudget> mGpuMemoryBudget;
+    QScopedPointer<QMirClientFrameRatePolicy> mFrameRatePolicy;
+    QScopedPointer<QMirClientProgramBinaryCache> mProgramBinaryCache;
+    QScopedPointer<QMirClientStateArchive> mStateArchive;
     qreal mScaleFactor;
 
     MirConnection *mMirConnection;
@@ -126,6 +142,10 @@ private:
     // EGL related
     EGLDisplay mEglDisplay{EGL_NO_DISPLAY};
     EGLNativeDisplayType mEglNativeDisplay;
+    // eglInitialize runs in the background, any use of mEglDisplay must wait for it
+    mutable std::thread mEglInitializeThread;
+    mutable std::once_flag mEglInitializeJoined;
+    EGLBoolean mEglInitialized{EGL_FALSE};
 };
 
 #endif // QMIRCLIENTINTEGRATION_H
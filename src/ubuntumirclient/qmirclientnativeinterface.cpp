@@ -41,56 +41,77 @@
 // Local
 #include "qmirclientnativeinterface.h"
 #include "qmirclientscreen.h"
+#include "qmirclientflightrecorder.h"
+#include "qmirclientframetimings.h"
 #include "qmirclientglcontext.h"
+#include "qmirclientperfcounters.h"
+#include "qmirclientprogrambinarycache.h"
+#include "qmirclientstatearchive.h"
 #include "qmirclientwindow.h"
 
 // Qt
 #include <QtGui/private/qguiapplication_p.h>
 #include <QtGui/qopenglcontext.h>
 #include <QtGui/qscreen.h>
-#include <QtCore/QMap>
-
-class UbuntuResourceMap : public QMap<QByteArray, QMirClientNativeInterface::ResourceType>
-{
-public:
-    UbuntuResourceMap()
-        : QMap<QByteArray, QMirClientNativeInterface::ResourceType>() {
-        insert("egldisplay", QMirClientNativeInterface::EglDisplay);
-        insert("eglcontext", QMirClientNativeInterface::EglContext);
-        insert("nativeorientation", QMirClientNativeInterface::NativeOrientation);
-        insert("display", QMirClientNativeInterface::Display);
-        insert("mirconnection", QMirClientNativeInterface::MirConnection);
-        insert("mirwindow", QMirClientNativeInterface::MirWindow);
-        insert("scale", QMirClientNativeInterface::Scale);
-        insert("formfactor", QMirClientNativeInterface::FormFactor);
-    }
-};
 
-Q_GLOBAL_STATIC(UbuntuResourceMap, ubuntuResourceMap)
+namespace {
+
+QMirClientProgramBinaryCache *programBinaryCache()
+{
+    auto integration = static_cast<QMirClientClientIntegration*>(QGuiApplicationPrivate::platformIntegration());
+    return integration->programBinaryCache();
+}
+
+bool loadProgramBinary(GLuint program, const QByteArray &sources)
+{
+    return programBinaryCache()->load(program, sources);
+}
+
+void saveProgramBinary(GLuint program, const QByteArray &sources)
+{
+    programBinaryCache()->save(program, sources);
+}
+
+QMirClientStateArchive *stateArchive()
+{
+    auto integration = static_cast<QMirClientClientIntegration*>(QGuiApplicationPrivate::platformIntegration());
+    return integration->stateArchive();
+}
+
+QByteArray restoredState(const QByteArray &key)
+{
+    return stateArchive()->restoredValue(key);
+}
+
+void setState(const QByteArray &key, const QByteArray &value)
+{
+    stateArchive()->setValue(key, value);
+}
+
+bool saveState()
+{
+    return stateArchive()->save();
+}
+
+} // anonymous namespace
 
 QMirClientNativeInterface::QMirClientNativeInterface(const QMirClientClientIntegration *integration)
     : mIntegration(integration)
     , mGenericEventFilterType(QByteArrayLiteral("Event"))
-    , mNativeOrientation(nullptr)
 {
 }
 
 QMirClientNativeInterface::~QMirClientNativeInterface()
 {
-    delete mNativeOrientation;
-    mNativeOrientation = nullptr;
 }
 
 void* QMirClientNativeInterface::nativeResourceForIntegration(const QByteArray &resourceString)
 {
-    const QByteArray lowerCaseResource = resourceString.toLower();
-
-    if (!ubuntuResourceMap()->contains(lowerCaseResource)) {
+    ResourceType resourceType;
+    if (!lookupResource(resourceString, &resourceType)) {
         return nullptr;
     }
 
-    const ResourceType resourceType = ubuntuResourceMap()->value(lowerCaseResource);
-
     if (resourceType == QMirClientNativeInterface::MirConnection) {
         return mIntegration->mirConnection();
     } else {
@@ -98,19 +119,52 @@ void* QMirClientNativeInterface::nativeResourceForIntegration(const QByteArray &
     }
 }
 
+QPlatformNativeInterface::NativeResourceForIntegrationFunction
+QMirClientNativeInterface::nativeResourceFunctionForIntegration(const QByteArray &resourceString)
+{
+    ResourceType resourceType;
+    if (!lookupResource(resourceString, &resourceType)) {
+        return nullptr;
+    }
+
+    // Use with the signatures declared in qmirclientprogrambinarycache.h, qmirclientperfcounters.h,
+    // qmirclientflightrecorder.h and qmirclientstatearchive.h
+    if (resourceType == QMirClientNativeInterface::LoadProgramBinary) {
+        const QMirClientLoadProgramBinaryFunction function = &loadProgramBinary;
+        return reinterpret_cast<NativeResourceForIntegrationFunction>(function);
+    } else if (resourceType == QMirClientNativeInterface::SaveProgramBinary) {
+        const QMirClientSaveProgramBinaryFunction function = &saveProgramBinary;
+        return reinterpret_cast<NativeResourceForIntegrationFunction>(function);
+    } else if (resourceType == QMirClientNativeInterface::PerfCounters) {
+        const QMirClientPerfCountersFunction function = &QMirClientPerfCounters::snapshot;
+        return reinterpret_cast<NativeResourceForIntegrationFunction>(function);
+    } else if (resourceType == QMirClientNativeInterface::DumpFlightRecorder) {
+        const QMirClientDumpFlightRecorderFunction function = &QMirClientFlightRecorder::dump;
+        return reinterpret_cast<NativeResourceForIntegrationFunction>(function);
+    } else if (resourceType == QMirClientNativeInterface::RestoredState) {
+        const QMirClientRestoredStateFunction function = &restoredState;
+        return reinterpret_cast<NativeResourceForIntegrationFunction>(function);
+    } else if (resourceType == QMirClientNativeInterface::SetState) {
+        const QMirClientSetStateFunction function = &setState;
+        return reinterpret_cast<NativeResourceForIntegrationFunction>(function);
+    } else if (resourceType == QMirClientNativeInterface::SaveState) {
+        const QMirClientSaveStateFunction function = &saveState;
+        return reinterpret_cast<NativeResourceForIntegrationFunction>(function);
+    } else {
+        return nullptr;
+    }
+}
+
 void* QMirClientNativeInterface::nativeResourceForContext(
     const QByteArray& resourceString, QOpenGLContext* context)
 {
     if (!context)
         return nullptr;
 
-    const QByteArray kLowerCaseResource = resourceString.toLower();
-
-    if (!ubuntuResourceMap()->contains(kLowerCaseResource))
+    ResourceType kResourceType;
+    if (!lookupResource(resourceString, &kResourceType))
         return nullptr;
 
-    const ResourceType kResourceType = ubuntuResourceMap()->value(kLowerCaseResource);
-
     if (kResourceType == QMirClientNativeInterface::EglContext)
         return static_cast<QMirClientOpenGLContext*>(context->handle())->eglContext();
     else
@@ -119,24 +173,20 @@ void* QMirClientNativeInterface::nativeResourceForContext(
 
 void* QMirClientNativeInterface::nativeResourceForWindow(const QByteArray& resourceString, QWindow* window)
 {
-    const QByteArray kLowerCaseResource = resourceString.toLower();
-    if (!ubuntuResourceMap()->contains(kLowerCaseResource))
+    ResourceType kResourceType;
+    if (!lookupResource(resourceString, &kResourceType))
         return NULL;
-    const ResourceType kResourceType = ubuntuResourceMap()->value(kLowerCaseResource);
 
     switch (kResourceType) {
     case EglDisplay:
         return mIntegration->eglDisplay();
     case NativeOrientation:
-        // Return the device's native screen orientation.
-        if (window) {
-            QMirClientScreen *ubuntuScreen = static_cast<QMirClientScreen*>(window->screen()->handle());
-            mNativeOrientation = new Qt::ScreenOrientation(ubuntuScreen->nativeOrientation());
-        } else {
-            QPlatformScreen *platformScreen = QGuiApplication::primaryScreen()->handle();
-            mNativeOrientation = new Qt::ScreenOrientation(platformScreen->nativeOrientation());
-        }
-        return mNativeOrientation;
+    {
+        // Return the device's native screen orientation, owned by the screen so that lookups for
+        // different screens don't overwrite each other
+        QScreen *screen = window ? window->screen() : QGuiApplication::primaryScreen();
+        return &static_cast<QMirClientScreen*>(screen->handle())->mNativeOrientation;
+    }
     case MirWindow:
         if (window) {
             auto ubuntuWindow = static_cast<QMirClientWindow*>(window->handle());
@@ -155,10 +205,9 @@ void* QMirClientNativeInterface::nativeResourceForWindow(const QByteArray& resou
 
 void* QMirClientNativeInterface::nativeResourceForScreen(const QByteArray& resourceString, QScreen* screen)
 {
-    const QByteArray kLowerCaseResource = resourceString.toLower();
-    if (!ubuntuResourceMap()->contains(kLowerCaseResource))
+    ResourceType kResourceType;
+    if (!lookupResource(resourceString, &kResourceType))
         return NULL;
-    const ResourceType kResourceType = ubuntuResourceMap()->value(kLowerCaseResource);
     if (!screen)
         screen = QGuiApplication::primaryScreen();
     auto ubuntuScreen = static_cast<QMirClientScreen*>(screen->handle());
@@ -187,6 +236,7 @@ QVariantMap QMirClientNativeInterface::windowProperties(QPlatformWindow *window)
         propertyMap.insert("scale", w->scale());
         propertyMap.insert("formFactor", w->formFactor());
         propertyMap.insert("persistentSurfaceId", w->persistentSurfaceId());
+        propertyMap.insert("rawPointer", w->rawPointer());
     }
     return propertyMap;
 }
@@ -204,6 +254,22 @@ QVariant QMirClientNativeInterface::windowProperty(QPlatformWindow *window, cons
         return w->formFactor();
     }  else if (name == QStringLiteral("persistentSurfaceId")) {
         return w->persistentSurfaceId();
+    } else if (name == QStringLiteral("frameTimings")) {
+        // Only filled when QTUBUNTU_GPU_FRAME_TIMING is set, and not announced by windowPropertyChanged
+        QVariantList frames;
+        Q_FOREACH (const auto &frame, w->frameTimings()->frames()) {
+            QVariantMap frameMap;
+            frameMap.insert("frame", frame.number);
+            frameMap.insert("cpuSubmitTime", frame.cpuSubmitTime / 1000);
+            frameMap.insert("gpuTime", frame.gpuTime < 0 ? -1 : frame.gpuTime / 1000);
+            frameMap.insert("swapBlockTime", frame.swapBlockTime / 1000);
+            frames.append(frameMap);
+        }
+        return frames;
+    } else if (name == QStringLiteral("maxFrameRate")) {
+        return w->frameRateCap();
+    } else if (name == QStringLiteral("rawPointer")) {
+        return w->rawPointer();
     } else {
         return QVariant();
     }
@@ -218,3 +284,18 @@ QVariant QMirClientNativeInterface::windowProperty(QPlatformWindow *window, cons
         return returnVal;
     }
 }
+
+void QMirClientNativeInterface::setWindowProperty(QPlatformWindow *window, const QString &name, const QVariant &value)
+{
+    auto w = static_cast<QMirClientWindow*>(window);
+    if (!w) {
+        return;
+    }
+
+    if (name == QStringLiteral("maxFrameRate")) {
+        // An invalid value hands the window back to the frame rate policy
+        w->setFrameRateCap(value.isValid() ? value.toReal() : -1);
+    } else if (name == QStringLiteral("rawPointer")) {
+        w->setRawPointer(value.toBool());
+    }
+}
@@ -50,13 +50,16 @@ class QPlatformScreen;
 class QMirClientNativeInterface : public QPlatformNativeInterface {
     Q_OBJECT
 public:
-    enum ResourceType { EglDisplay, EglContext, NativeOrientation, Display, MirConnection, MirWindow, Scale, FormFactor };
+    enum ResourceType { EglDisplay, EglContext, NativeOrientation, Display, MirConnection, MirWindow, Scale, FormFactor,
+                        LoadProgramBinary, SaveProgramBinary, PerfCounters, DumpFlightRecorder,
+                        RestoredState, SetState, SaveState };
 
     QMirClientNativeInterface(const QMirClientClientIntegration *integration);
     ~QMirClientNativeInterface();
 
     // QPlatformNativeInterface methods.
     void* nativeResourceForIntegration(const QByteArray &resource) override;
+    NativeResourceForIntegrationFunction nativeResourceFunctionForIntegration(const QByteArray &resource) override;
     void* nativeResourceForContext(const QByteArray& resourceString,
                                    QOpenGLContext* context) override;
     void* nativeResourceForWindow(const QByteArray& resourceString,
@@ -67,9 +70,12 @@ public:
     QVariantMap windowProperties(QPlatformWindow *window) const override;
     QVariant windowProperty(QPlatformWindow *window, const QString &name) const override;
     QVariant windowProperty(QPlatformWindow *window, const QString &name, const QVariant &defaultValue) const override;
+    void setWindowProperty(QPlatformWindow *window, const QString &name, const QVariant &value) override;
 
     // New methods.
     const QByteArray& genericEventFilterType() const { return mGenericEventFilterType; }
+    // Case insensitive, see qmirclientnativeresources.cpp
+    static bool lookupResource(const QByteArray &resourceString, ResourceType *type);
 
 Q_SIGNALS: // New signals
     void screenPropertyChanged(QPlatformScreen *screen, const QString &propertyName);
@@ -77,7 +83,6 @@ Q_SIGNALS: // New signals
 private:
     const QMirClientClientIntegration *mIntegration;
     const QByteArray mGenericEventFilterType;
-    Qt::ScreenOrientation* mNativeOrientation;
 };
 
 #endif // QMIRCLIENTNATIVEINTERFACE_H
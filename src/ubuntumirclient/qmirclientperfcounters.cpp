@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmirclientperfcounters.h"
+#include "qmirclientinput.h"
+#include "qmirclientlogging.h"
+
+#include <QTimer>
+
+Q_LOGGING_CATEGORY(mirclientPerf, "qt.qpa.mirclient.perf", QtWarningMsg)
+
+std::atomic<quint64> QMirClientPerfCounters::sCounters[QMirClientPerfCounters::CounterCount];
+std::atomic<quint64> QMirClientPerfCounters::sEvents[QMirClientPerfCounters::MaxEventTypes];
+
+namespace {
+
+const char *counterName(QMirClientPerfCounters::Counter counter)
+{
+    switch (counter) {
+    case QMirClientPerfCounters::StaleResizesDropped:
+        return "staleResizesDropped";
+    case QMirClientPerfCounters::WheelEventsCoalesced:
+        return "wheelEventsCoalesced";
+    case QMirClientPerfCounters::ExposeEventsCoalesced:
+        return "exposeEventsCoalesced";
+    case QMirClientPerfCounters::WindowSpecsApplied:
+        return "windowSpecsApplied";
+    case QMirClientPerfCounters::WindowsCreated:
+        return "windowsCreated";
+    case QMirClientPerfCounters::WindowsDestroyed:
+        return "windowsDestroyed";
+    case QMirClientPerfCounters::BufferSwaps:
+        return "bufferSwaps";
+    case QMirClientPerfCounters::ExposeEventsSent:
+        return "exposeEventsSent";
+    case QMirClientPerfCounters::ClipboardRoundTrips:
+        return "clipboardRoundTrips";
+    case QMirClientPerfCounters::DBusRoundTrips:
+        return "dbusRoundTrips";
+    case QMirClientPerfCounters::CompositorRoundTrips:
+        return "compositorRoundTrips";
+    case QMirClientPerfCounters::WindowBuffersReleased:
+        return "windowBuffersReleased";
+    case QMirClientPerfCounters::CounterCount:
+        break;
+    }
+    Q_UNREACHABLE();
+    return nullptr;
+}
+
+} // anonymous namespace
+
+QVariantMap QMirClientPerfCounters::snapshot()
+{
+    QVariantMap counters;
+    for (int i = 0; i < CounterCount; ++i) {
+        counters.insert(QLatin1String(counterName(static_cast<Counter>(i))),
+                        sCounters[i].load(std::memory_order_relaxed));
+    }
+
+    QVariantMap events;
+    for (int type = 0; type < MaxEventTypes; ++type) {
+        const quint64 count = sEvents[type].load(std::memory_order_relaxed);
+        if (count > 0) {
+            events.insert(QLatin1String(qmirclientNativeEventTypeToStr(static_cast<MirEventType>(type))), count);
+        }
+    }
+    counters.insert(QStringLiteral("eventsReceived"), events);
+
+    return counters;
+}
+
+void QMirClientPerfCounters::startPeriodicDump(QObject *parent)
+{
+    if (!mirclientPerf().isDebugEnabled()) {
+        return;
+    }
+
+    bool ok;
+    int interval = qgetenv("QTUBUNTU_PERF_COUNTERS_INTERVAL").toInt(&ok);
+    if (!ok || interval <= 0) {
+        interval = 10000;
+    }
+
+    auto timer = new QTimer(parent);
+    QObject::connect(timer, &QTimer::timeout, []() {
+        qCDebug(mirclientPerf) << "perfcounters" << snapshot();
+    });
+    timer->start(interval);
+}
@@ -0,0 +1,109 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QMIRCLIENTPERFCOUNTERS_H
+#define QMIRCLIENTPERFCOUNTERS_H
+
+#include <QVariantMap>
+
+#include <atomic>
+
+/*
+ * QMirClientPerfCounters - plugin-wide counters of what the plugin is doing.
+ *
+ * Cheap enough to be always on: every update is a single relaxed atomic increment. Read them
+ * through the "perfcounters" native resource function, or have them dumped periodically by enabling the
+ * qt.qpa.mirclient.perf logging category.
+ */
+class QMirClientPerfCounters
+{
+public:
+    enum Counter {
+        StaleResizesDropped,
+        WheelEventsCoalesced,
+        ExposeEventsCoalesced,
+        WindowSpecsApplied,
+        WindowsCreated,
+        WindowsDestroyed,
+        BufferSwaps,
+        ExposeEventsSent,
+        ClipboardRoundTrips,
+        DBusRoundTrips,
+        CompositorRoundTrips,
+        WindowBuffersReleased,
+        CounterCount
+    };
+
+    static void increment(Counter counter)
+    {
+        sCounters[counter].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Counted per Mir event type
+    static void eventReceived(int eventType)
+    {
+        if (eventType >= 0 && eventType < MaxEventTypes) {
+            sEvents[eventType].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static quint64 value(Counter counter)
+    {
+        return sCounters[counter].load(std::memory_order_relaxed);
+    }
+
+    static QVariantMap snapshot();
+
+    // Dumps the counters every QTUBUNTU_PERF_COUNTERS_INTERVAL milliseconds (10000 by default)
+    // if the qt.qpa.mirclient.perf logging category is enabled for debug messages
+    static void startPeriodicDump(QObject *parent);
+
+private:
+    enum { MaxEventTypes = 32 };
+
+    static std::atomic<quint64> sCounters[CounterCount];
+    static std::atomic<quint64> sEvents[MaxEventTypes];
+};
+
+// Signature of the function exposed through QPlatformNativeInterface::nativeResourceFunctionForIntegration()
+// as "perfcounters". Every call returns a fresh snapshot.
+typedef QVariantMap (*QMirClientPerfCountersFunction)();
+
+#endif // QMIRCLIENTPERFCOUNTERS_H
@@ -39,6 +39,7 @@
 
 
 #include "qmirclientplatformservices.h"
+#include "qmirclientperfcounters.h"
 
 #include <QUrl>
 
@@ -62,6 +63,7 @@ bool QMirClientPlatformServices::callDispatcher(const QUrl &url)
         return false;
 
     ua_url_dispatcher_session_open(session, url.toEncoded().constData(), NULL, NULL);
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::DBusRoundTrips);
 
     free(session);
 
@@ -41,6 +41,7 @@
 #include "qmirclientplugin.h"
 #include "qmirclientintegration.h"
 #include "qmirclientlogging.h"
+#include "qmirclientstartuptrace.h"
 
 Q_LOGGING_CATEGORY(mirclient, "qt.qpa.mirclient", QtWarningMsg)
 
@@ -49,6 +50,7 @@ QPlatformIntegration *QMirClientIntegrationPlugin::create(const QString &system,
                                                           int &argc, char **argv)
 {
     if (system.toLower() == QLatin1String("ubuntumirclient")) {
+        QMirClientStartupTrace::addMark("pluginCreate");
 #ifdef PLATFORM_API_TOUCH
         setenv("UBUNTU_PLATFORM_API_BACKEND", "touch_mirclient", 1);
 #else
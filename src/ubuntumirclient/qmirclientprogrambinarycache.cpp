@@ -0,0 +1,311 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmirclientprogrambinarycache.h"
+#include "qmirclientlogging.h"
+
+// Qt
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFunctions>
+
+#include <utime.h>
+
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+
+namespace {
+
+const quint32 BinaryMagic = 0x51555042; // "QUPB"
+const quint32 BinaryFormatVersion = 1;
+const qint64 DefaultMaxCacheSize = 8 * 1024 * 1024;
+
+QByteArray glString(QOpenGLFunctions *functions, GLenum name)
+{
+    return QByteArray(reinterpret_cast<const char *>(functions->glGetString(name)));
+}
+
+} // anonymous namespace
+
+QMirClientProgramBinaryCache::QMirClientProgramBinaryCache()
+    : mEnabled(qEnvironmentVariableIsEmpty("QTUBUNTU_NO_PROGRAM_BINARY_CACHE"))
+    , mMaxSize(DefaultMaxCacheSize)
+{
+    const QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheLocation.isEmpty()) {
+        mEnabled = false;
+    }
+    mDirectory = cacheLocation + QStringLiteral("/qtubuntu/programbinaries");
+
+    bool ok;
+    const qint64 maxSizeKb = qgetenv("QTUBUNTU_PROGRAM_BINARY_CACHE_SIZE").toLongLong(&ok);
+    if (ok && maxSizeKb >= 0) {
+        mMaxSize = maxSizeKb * 1024;
+    }
+    if (mMaxSize == 0) {
+        mEnabled = false;
+    }
+}
+
+bool QMirClientProgramBinaryCache::isEnabled() const
+{
+    QMutexLocker lock(&mMutex);
+    return mEnabled;
+}
+
+bool QMirClientProgramBinaryCache::resolveFunctions(QOpenGLContext *context)
+{
+    QMutexLocker lock(&mMutex);
+
+    if (!mEnabled) {
+        return false;
+    }
+
+    if (!mFunctionsResolved) {
+        mFunctionsResolved = true;
+
+        if (context->isOpenGLES()) {
+            if (context->hasExtension("GL_OES_get_program_binary")) {
+                mGetProgramBinary = reinterpret_cast<GetProgramBinaryFunction>(context->getProcAddress("glGetProgramBinaryOES"));
+                mProgramBinary = reinterpret_cast<ProgramBinaryFunction>(context->getProcAddress("glProgramBinaryOES"));
+            }
+            // The retrievable hint is core in OpenGL ES 3, OES_get_program_binary keeps every binary retrievable
+            if (context->format().majorVersion() >= 3) {
+                mProgramParameteri = reinterpret_cast<ProgramParameteriFunction>(context->getProcAddress("glProgramParameteri"));
+            }
+        } else if (context->hasExtension("GL_ARB_get_program_binary")) {
+            mGetProgramBinary = reinterpret_cast<GetProgramBinaryFunction>(context->getProcAddress("glGetProgramBinary"));
+            mProgramBinary = reinterpret_cast<ProgramBinaryFunction>(context->getProcAddress("glProgramBinary"));
+            mProgramParameteri = reinterpret_cast<ProgramParameteriFunction>(context->getProcAddress("glProgramParameteri"));
+        }
+
+        // The extension can be advertised while the driver offers no binary format at all. Only
+        // queried with the extension, GL_NUM_PROGRAM_BINARY_FORMATS being an invalid enum without.
+        GLint formatCount = 0;
+        if (mGetProgramBinary && mProgramBinary) {
+            context->functions()->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        }
+        if (formatCount <= 0) {
+            mGetProgramBinary = nullptr;
+            mProgramBinary = nullptr;
+            mProgramParameteri = nullptr;
+        }
+
+        qCDebug(mirclientGraphics, "Program binary cache %s (%d binary formats, directory %s)",
+                mProgramBinary ? "available" : "not supported by driver", formatCount, qPrintable(mDirectory));
+    }
+
+    return mGetProgramBinary && mProgramBinary;
+}
+
+QString QMirClientProgramBinaryCache::filePath(const QByteArray &renderer, const QByteArray &driverVersion,
+                                               const QByteArray &sources) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(renderer);
+    hash.addData("\0", 1);
+    hash.addData(driverVersion);
+    hash.addData("\0", 1);
+    hash.addData(sources);
+
+    return mDirectory + QLatin1Char('/') + QString::fromLatin1(hash.result().toHex()) + QStringLiteral(".bin");
+}
+
+bool QMirClientProgramBinaryCache::load(GLuint program, const QByteArray &sources)
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (!context || !resolveFunctions(context)) {
+        return false;
+    }
+
+    if (loadBinary(context, program, sources)) {
+        return true;
+    }
+
+    // The program gets linked from its sources, for save() to retrieve its binary afterwards
+    if (mProgramParameteri) {
+        mProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    return false;
+}
+
+bool QMirClientProgramBinaryCache::loadBinary(QOpenGLContext *context, GLuint program, const QByteArray &sources)
+{
+    QOpenGLFunctions *functions = context->functions();
+    const QByteArray renderer = glString(functions, GL_RENDERER);
+    const QByteArray driverVersion = glString(functions, GL_VERSION);
+    const QString path = filePath(renderer, driverVersion, sources);
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (stream.status() != QDataStream::Ok || magic != BinaryMagic || version != BinaryFormatVersion) {
+        qCDebug(mirclientGraphics) << "Discarding program binary with unknown format" << path;
+        QFile::remove(path);
+        return false;
+    }
+
+    QByteArray storedRenderer;
+    QByteArray storedDriverVersion;
+    quint32 binaryFormat = 0;
+    QByteArray binary;
+    quint16 checksum = 0;
+    stream >> storedRenderer >> storedDriverVersion >> binaryFormat >> binary >> checksum;
+    file.close();
+
+    if (stream.status() != QDataStream::Ok
+            || storedRenderer != renderer || storedDriverVersion != driverVersion
+            || checksum != qChecksum(binary.constData(), binary.size())) {
+        qCDebug(mirclientGraphics) << "Discarding stale or corrupt program binary" << path;
+        QFile::remove(path);
+        return false;
+    }
+
+    mProgramBinary(program, binaryFormat, binary.constData(), binary.size());
+
+    // The driver is free to reject a binary it produced itself, e.g. after an update
+    GLint linked = GL_FALSE;
+    functions->glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE) {
+        qCDebug(mirclientGraphics) << "Driver rejected program binary" << path;
+        QFile::remove(path);
+        return false;
+    }
+
+    // Bump the modification time, it is what the eviction goes by
+    utime(QFile::encodeName(path).constData(), nullptr);
+
+    return true;
+}
+
+void QMirClientProgramBinaryCache::save(GLuint program, const QByteArray &sources)
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (!context || !resolveFunctions(context)) {
+        return;
+    }
+
+    QOpenGLFunctions *functions = context->functions();
+
+    GLint length = 0;
+    functions->glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    QByteArray binary(length, Qt::Uninitialized);
+    GLsizei binaryLength = 0;
+    GLenum binaryFormat = 0;
+    mGetProgramBinary(program, length, &binaryLength, &binaryFormat, binary.data());
+    if (binaryLength <= 0) {
+        return;
+    }
+    binary.resize(binaryLength);
+
+    const QByteArray renderer = glString(functions, GL_RENDERER);
+    const QByteArray driverVersion = glString(functions, GL_VERSION);
+    const QString path = filePath(renderer, driverVersion, sources);
+
+    QMutexLocker lock(&mMutex);
+
+    if (!mEnabled) {
+        return;
+    }
+
+    if (!QDir().mkpath(mDirectory)) {
+        qCWarning(mirclientGraphics) << "Unable to create program binary cache directory" << mDirectory;
+        mEnabled = false;
+        return;
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(mirclientGraphics) << "Unable to write program binary" << path << file.errorString();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << BinaryMagic << BinaryFormatVersion << renderer << driverVersion << quint32(binaryFormat) << binary
+           << qChecksum(binary.constData(), binary.size());
+
+    if (!file.commit()) {
+        qCWarning(mirclientGraphics) << "Unable to write program binary" << path << file.errorString();
+        return;
+    }
+
+    evictLeastRecentlyUsed();
+}
+
+void QMirClientProgramBinaryCache::evictLeastRecentlyUsed()
+{
+    // QDir::Time lists the most recently modified files first
+    const QFileInfoList entries = QDir(mDirectory).entryInfoList(QDir::Files, QDir::Time);
+
+    qint64 totalSize = 0;
+    for (const QFileInfo &entry : entries) {
+        totalSize += entry.size();
+        if (totalSize > mMaxSize) {
+            qCDebug(mirclientGraphics) << "Evicting program binary" << entry.fileName();
+            QFile::remove(entry.filePath());
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QMIRCLIENTPROGRAMBINARYCACHE_H
+#define QMIRCLIENTPROGRAMBINARYCACHE_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QtGui/qopenglfunctions.h>
+
+class QOpenGLContext;
+
+/*
+ * QMirClientProgramBinaryCache - persistent on-disk cache of linked GL program binaries.
+ *
+ * Relies on GL_OES_get_program_binary (or GL_ARB_get_program_binary on desktop GL). Entries are
+ * keyed by GL_RENDERER, GL_VERSION (which carries the driver version) and the shader sources,
+ * and are validated on load. The cache directory is kept under a size cap, evicting the least
+ * recently used entries first.
+ */
+class QMirClientProgramBinaryCache
+{
+public:
+    QMirClientProgramBinaryCache();
+
+    bool isEnabled() const;
+
+    // Both operate on the current OpenGL context. "sources" should contain the full source
+    // of every shader attached to the program. When load() fails the program has to be
+    // compiled and linked as usual, after which save() stores its binary for the next run
+    // (load() having asked the driver to keep the binary of the program retrievable).
+    bool load(GLuint program, const QByteArray &sources);
+    void save(GLuint program, const QByteArray &sources);
+
+private:
+    bool resolveFunctions(QOpenGLContext *context);
+    bool loadBinary(QOpenGLContext *context, GLuint program, const QByteArray &sources);
+    QString filePath(const QByteArray &renderer, const QByteArray &driverVersion, const QByteArray &sources) const;
+    void evictLeastRecentlyUsed();
+
+    typedef void (QOPENGLF_APIENTRYP GetProgramBinaryFunction)(GLuint program, GLsizei bufSize, GLsizei *length,
+                                                              GLenum *binaryFormat, void *binary);
+    typedef void (QOPENGLF_APIENTRYP ProgramBinaryFunction)(GLuint program, GLenum binaryFormat,
+                                                           const void *binary, GLint length);
+    typedef void (QOPENGLF_APIENTRYP ProgramParameteriFunction)(GLuint program, GLenum pname, GLint value);
+
+    bool mEnabled;
+    QString mDirectory;
+    qint64 mMaxSize;
+
+    mutable QMutex mMutex;
+    bool mFunctionsResolved{false};
+    GetProgramBinaryFunction mGetProgramBinary{nullptr};
+    ProgramBinaryFunction mProgramBinary{nullptr};
+    ProgramParameteriFunction mProgramParameteri{nullptr};
+};
+
+// Signatures of the functions exposed through QPlatformNativeInterface::nativeResourceFunctionForIntegration()
+// as "loadprogrambinary" and "saveprogrambinary"
+typedef bool (*QMirClientLoadProgramBinaryFunction)(GLuint program, const QByteArray &sources);
+typedef void (*QMirClientSaveProgramBinaryFunction)(GLuint program, const QByteArray &sources);
+
+#endif // QMIRCLIENTPROGRAMBINARYCACHE_H
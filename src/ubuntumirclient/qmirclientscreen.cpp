@@ -223,7 +223,7 @@ void QMirClientScreen::setMirOutput(const MirOutput *output)
 
 void QMirClientScreen::updateMirOutput(const MirOutput *output)
 {
-    auto oldRefreshRate = mRefreshRate;
+    const qreal oldRefreshRate = mRefreshRate;
     auto oldScale = mScale;
     auto oldFormFactor = mFormFactor;
     auto oldGeometry = mGeometry;
@@ -237,7 +237,7 @@ void QMirClientScreen::updateMirOutput(const MirOutput *output)
                                                            mGeometry /* newAvailableGeometry */);
     }
 
-    if (!qFuzzyCompare(mRefreshRate, oldRefreshRate)) {
+    if (!qFuzzyCompare(mRefreshRate.load(), oldRefreshRate)) {
         QWindowSystemInterface::handleScreenRefreshRateChange(screen(), mRefreshRate);
     }
 
@@ -48,6 +48,8 @@
 
 #include "qmirclientcursor.h"
 
+#include <atomic>
+
 struct MirConnection;
 struct MirOutput;
 
@@ -68,6 +70,7 @@ public:
     QDpi logicalDpi() const override;
     Qt::ScreenOrientation nativeOrientation() const override { return mNativeOrientation; }
     Qt::ScreenOrientation orientation() const override { return mNativeOrientation; }
+    qreal refreshRate() const override { return mRefreshRate; }
     QPlatformCursor *cursor() const override { return const_cast<QMirClientCursor*>(&mCursor); }
 
     // Additional Screen properties from Mir
@@ -94,7 +97,7 @@ private:
     Qt::ScreenOrientation mCurrentOrientation;
     QImage::Format mFormat;
     int mDepth;
-    qreal mRefreshRate;
+    std::atomic<double> mRefreshRate; // read by the rendering threads, see QMirClientWindow::applyFrameRateCap()
     MirFormFactor mFormFactor;
     float mScale;
     int mOutputId;
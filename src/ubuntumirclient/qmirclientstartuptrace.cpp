@@ -0,0 +1,261 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmirclientstartuptrace.h"
+#include "qmirclientlogging.h"
+#include "qmirclientprocessmemory.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+
+#include <atomic>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+struct Event {
+    const char *name;
+    qint64 start;
+    qint64 duration; // -1 for marks
+    qint64 threadId;
+};
+
+struct Trace {
+    Trace() : path(qgetenv("QTUBUNTU_STARTUP_TRACE")) { active = !path.isEmpty(); }
+
+    std::atomic<bool> active;
+    QMutex mutex;
+    const QByteArray path;
+    QVector<Event> events;
+    std::atomic<quint64 (*)()> compositorRoundTrips{nullptr};
+};
+
+Trace *trace()
+{
+    static Trace instance;
+    return &instance;
+}
+
+qint64 currentThreadId()
+{
+    return static_cast<qint64>(syscall(SYS_gettid));
+}
+
+// In boot clock microseconds, or -1 if it can't be read
+qint64 processStartTime()
+{
+    QFile file(QStringLiteral("/proc/self/stat"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    // The command name is in parentheses and may contain spaces, fields are counted from there
+    const QByteArray stat = file.readAll();
+    const int commandEnd = stat.lastIndexOf(')');
+    if (commandEnd < 0) {
+        return -1;
+    }
+
+    const QList<QByteArray> fields = stat.mid(commandEnd + 2).split(' ');
+    const int startTimeField = 22 - 3; // "state" is field 3
+    if (fields.count() <= startTimeField) {
+        return -1;
+    }
+
+    bool ok;
+    const qint64 ticks = fields.at(startTimeField).toLongLong(&ok);
+    const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    if (!ok || ticksPerSecond <= 0) {
+        return -1;
+    }
+    return ticks * 1000000 / ticksPerSecond;
+}
+
+} // anonymous namespace
+
+QMirClientStartupTrace::Phase::Phase(const char *name)
+    : mName(name)
+    , mStart(isActive() ? now() : 0)
+{
+}
+
+QMirClientStartupTrace::Phase::~Phase()
+{
+    if (mStart > 0) {
+        addPhase(mName, mStart, now());
+    }
+}
+
+bool QMirClientStartupTrace::isActive()
+{
+    return trace()->active.load(std::memory_order_relaxed);
+}
+
+void QMirClientStartupTrace::addPhase(const char *name, qint64 start, qint64 end)
+{
+    Trace *t = trace();
+    QMutexLocker lock(&t->mutex);
+    if (t->active) {
+        t->events.append(Event{name, start, end - start, currentThreadId()});
+    }
+}
+
+void QMirClientStartupTrace::addMark(const char *name)
+{
+    if (!isActive()) {
+        return;
+    }
+
+    Trace *t = trace();
+    const qint64 timestamp = now();
+    QMutexLocker lock(&t->mutex);
+    if (t->active) {
+        t->events.append(Event{name, timestamp, -1, currentThreadId()});
+    }
+}
+
+void QMirClientStartupTrace::setCompositorRoundTrips(quint64 (*roundTrips)())
+{
+    trace()->compositorRoundTrips = roundTrips;
+}
+
+void QMirClientStartupTrace::firstFrameSwapped()
+{
+    if (isActive()) {
+        addMark("firstFrameSwapped");
+        finish();
+    }
+}
+
+void QMirClientStartupTrace::finish()
+{
+    Trace *t = trace();
+    QMutexLocker lock(&t->mutex);
+    if (!t->active) {
+        return;
+    }
+    t->active = false;
+
+    // Phases get recorded as they end, so they aren't sorted by start
+    qint64 firstStart = now();
+    Q_FOREACH (const Event &event, t->events) {
+        firstStart = qMin(firstStart, event.start);
+    }
+
+    const qint64 pid = getpid();
+    const qint64 processStart = processStartTime();
+    const qint64 origin = processStart >= 0 ? processStart : firstStart;
+
+    QJsonArray events;
+    if (processStart >= 0) {
+        // Everything that happened before the plugin got loaded
+        events.append(QJsonObject{
+            {QStringLiteral("name"), QStringLiteral("beforePluginLoad")},
+            {QStringLiteral("cat"), QStringLiteral("qtubuntu")},
+            {QStringLiteral("ph"), QStringLiteral("X")},
+            {QStringLiteral("ts"), 0},
+            {QStringLiteral("dur"), firstStart - processStart},
+            {QStringLiteral("pid"), pid},
+            {QStringLiteral("tid"), pid}
+        });
+    }
+
+    qint64 firstFrame = -1;
+    Q_FOREACH (const Event &event, t->events) {
+        if (event.duration < 0 && qstrcmp(event.name, "firstFrameSwapped") == 0) {
+            firstFrame = event.start - origin;
+        }
+
+        QJsonObject object{
+            {QStringLiteral("name"), QString::fromLatin1(event.name)},
+            {QStringLiteral("cat"), QStringLiteral("qtubuntu")},
+            {QStringLiteral("ts"), event.start - origin},
+            {QStringLiteral("pid"), pid},
+            {QStringLiteral("tid"), event.threadId}
+        };
+        if (event.duration >= 0) {
+            object.insert(QStringLiteral("ph"), QStringLiteral("X"));
+            object.insert(QStringLiteral("dur"), event.duration);
+        } else {
+            object.insert(QStringLiteral("ph"), QStringLiteral("i"));
+            object.insert(QStringLiteral("s"), QStringLiteral("p"));
+        }
+        events.append(object);
+    }
+    t->events.clear();
+
+    QFile file(QString::fromLocal8Bit(t->path));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(mirclient, "Failed to write the startup trace to %s", t->path.constData());
+        return;
+    }
+
+    // Summary of the startup, for tools tracking it over time
+    const auto compositorRoundTrips = t->compositorRoundTrips.load();
+    const QJsonObject summary{
+        {QStringLiteral("timeToFirstFrame"), firstFrame},
+        {QStringLiteral("measuredFromProcessStart"), processStart >= 0},
+        {QStringLiteral("peakRssKb"), qmirclientProcessMemory("VmHWM")},
+        {QStringLiteral("compositorRoundTrips"),
+         compositorRoundTrips ? static_cast<qint64>(compositorRoundTrips()) : 0}
+    };
+
+    const QJsonObject document{
+        {QStringLiteral("traceEvents"), events},
+        {QStringLiteral("displayTimeUnit"), QStringLiteral("ms")},
+        {QStringLiteral("otherData"), summary}
+    };
+    file.write(QJsonDocument(document).toJson(QJsonDocument::Compact));
+    qCDebug(mirclient, "Startup trace written to %s", t->path.constData());
+}
+
+qint64 QMirClientStartupTrace::now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return static_cast<qint64>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
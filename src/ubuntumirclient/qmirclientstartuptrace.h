@@ -0,0 +1,90 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QMIRCLIENTSTARTUPTRACE_H
+#define QMIRCLIENTSTARTUPTRACE_H
+
+#include <QtGlobal>
+
+/*
+ * QMirClientStartupTrace - timeline of the plugin's startup, from process start to the first
+ * swapped frame.
+ *
+ * Only active when QTUBUNTU_STARTUP_TRACE names a file. Phases are timestamped with the boot
+ * clock, the one /proc uses for the process start time, and are written to that file as Chrome
+ * trace-event JSON (viewable in chrome://tracing) once the first frame has been swapped, or
+ * when the integration goes away if that never happens. Its "otherData" object summarizes the
+ * startup: "timeToFirstFrame" in microseconds (-1 if no frame got swapped) from process start,
+ * or from plugin load when "measuredFromProcessStart" is false, the peak RSS in KiB
+ * as "peakRssKb" and the number of blocking "compositorRoundTrips" made until then, which is 0
+ * unless a plugin talking to a compositor provides the count.
+ */
+class QMirClientStartupTrace
+{
+public:
+    // Records the lifetime of the enclosing scope as a phase
+    class Phase
+    {
+    public:
+        explicit Phase(const char *name);
+        ~Phase();
+
+    private:
+        const char *mName;
+        qint64 mStart;
+    };
+
+    static bool isActive();
+
+    // "name" must outlive the trace, string literals are expected
+    static void addPhase(const char *name, qint64 start, qint64 end);
+    static void addMark(const char *name);
+
+    // Read when the trace gets written
+    static void setCompositorRoundTrips(quint64 (*roundTrips)());
+
+    static void firstFrameSwapped();
+    static void finish();
+
+    // Microseconds since boot
+    static qint64 now();
+};
+
+#endif // QMIRCLIENTSTARTUPTRACE_H
@@ -0,0 +1,240 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmirclientstatearchive.h"
+#include "qmirclientlogging.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QVector>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char magic[4] = { 'Q', 'U', 'S', 'A' };
+const quint32 version = 1;
+
+struct Header {
+    char magic[4];
+    quint32 version;
+    quint32 entryCount;
+    quint32 size;
+};
+
+quint32 aligned(quint32 offset)
+{
+    return (offset + 7) & ~7u;
+}
+
+QString archivePath()
+{
+    const QString directory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return directory.isEmpty() ? QString() : directory + QStringLiteral("/qtubuntu-state");
+}
+
+} // anonymous namespace
+
+QMirClientStateArchive::QMirClientStateArchive()
+    : mPath(archivePath())
+{
+    map();
+}
+
+void QMirClientStateArchive::map()
+{
+    if (mPath.isEmpty()) {
+        return;
+    }
+
+    mFile.setFileName(mPath);
+    if (!mFile.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    const qint64 size = mFile.size();
+    const uchar *data = size >= qint64(sizeof(Header)) ? mFile.map(0, size) : nullptr;
+    if (!data) {
+        mFile.close();
+        return;
+    }
+
+    // Validate everything once, so that lookups can trust the offsets
+    const auto header = reinterpret_cast<const Header *>(data);
+    bool valid = memcmp(header->magic, magic, sizeof(magic)) == 0 && header->version == version
+            && header->size == size
+            && header->entryCount <= (size - sizeof(Header)) / sizeof(Entry);
+
+    const auto entries = reinterpret_cast<const Entry *>(data + sizeof(Header));
+    for (quint32 i = 0; valid && i < header->entryCount; ++i) {
+        const Entry &entry = entries[i];
+        valid = quint64(entry.keyOffset) + entry.keyLength <= quint64(size)
+                && quint64(entry.valueOffset) + entry.valueLength <= quint64(size);
+        if (valid && i > 0) {
+            const Entry &previous = entries[i - 1];
+            valid = QByteArray::fromRawData(reinterpret_cast<const char *>(data + previous.keyOffset), previous.keyLength)
+                    < QByteArray::fromRawData(reinterpret_cast<const char *>(data + entry.keyOffset), entry.keyLength);
+        }
+    }
+
+    if (!valid) {
+        qCWarning(mirclient) << "Ignoring invalid state archive" << mPath;
+        mFile.unmap(const_cast<uchar *>(data));
+        mFile.close();
+        return;
+    }
+
+    mData = data;
+    mEntries = entries;
+    mEntryCount = header->entryCount;
+    qCDebug(mirclient, "Mapped state archive with %u entries", mEntryCount);
+
+    // Consumed: should this run crash before saving, the next one mustn't restore the same state again.
+    // The mapping outlives the file, and the next save writes the restored entries back.
+    QFile::remove(mPath);
+    mDirty = mEntryCount > 0;
+}
+
+QByteArray QMirClientStateArchive::key(const Entry &entry) const
+{
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(mData + entry.keyOffset), entry.keyLength);
+}
+
+QByteArray QMirClientStateArchive::value(const Entry &entry) const
+{
+    // Keep empty values distinguishable from missing ones
+    if (entry.valueLength == 0) {
+        return QByteArray("");
+    }
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(mData + entry.valueOffset), entry.valueLength);
+}
+
+QByteArray QMirClientStateArchive::restoredValue(const QByteArray &searchedKey) const
+{
+    // The mapping itself never changes once constructed, so no need to lock
+    const Entry *end = mEntries + mEntryCount;
+    const Entry *entry = std::lower_bound(mEntries, end, searchedKey,
+                                          [this](const Entry &candidate, const QByteArray &key) {
+        return this->key(candidate) < key;
+    });
+    if (entry == end || key(*entry) != searchedKey) {
+        return QByteArray();
+    }
+    return value(*entry);
+}
+
+void QMirClientStateArchive::setValue(const QByteArray &key, const QByteArray &value)
+{
+    QMutexLocker lock(&mMutex);
+    mChanges.insert(key, value);
+    mDirty = true;
+}
+
+bool QMirClientStateArchive::save()
+{
+    QMutexLocker lock(&mMutex);
+    if (!mDirty || mPath.isEmpty()) {
+        return true;
+    }
+
+    // What the previous run left, updated with the changes
+    QMap<QByteArray, QByteArray> values;
+    for (quint32 i = 0; i < mEntryCount; ++i) {
+        values.insert(key(mEntries[i]), value(mEntries[i]));
+    }
+    for (auto it = mChanges.constBegin(); it != mChanges.constEnd(); ++it) {
+        if (it.value().isNull()) {
+            values.remove(it.key());
+        } else {
+            values.insert(it.key(), it.value());
+        }
+    }
+
+    QVector<Entry> entries;
+    entries.reserve(values.size());
+    quint32 offset = aligned(sizeof(Header) + values.size() * sizeof(Entry));
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        Entry entry;
+        entry.keyOffset = offset;
+        entry.keyLength = it.key().size();
+        entry.valueOffset = aligned(entry.keyOffset + entry.keyLength);
+        entry.valueLength = it.value().size();
+        offset = aligned(entry.valueOffset + entry.valueLength);
+        entries.append(entry);
+    }
+
+    Header header;
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.entryCount = entries.size();
+    header.size = offset;
+
+    QByteArray data(offset, '\0');
+    memcpy(data.data(), &header, sizeof(header));
+    memcpy(data.data() + sizeof(header), entries.constData(), entries.size() * sizeof(Entry));
+    int i = 0;
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it, ++i) {
+        memcpy(data.data() + entries[i].keyOffset, it.key().constData(), entries[i].keyLength);
+        memcpy(data.data() + entries[i].valueOffset, it.value().constData(), entries[i].valueLength);
+    }
+
+    // Replaced atomically, the current mapping stays valid as it refers to the old file
+    QDir().mkpath(QFileInfo(mPath).absolutePath());
+    QSaveFile file(mPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qCWarning(mirclient) << "Unable to write state archive" << mPath << file.errorString();
+        return false;
+    }
+
+    qCDebug(mirclient, "Saved state archive with %d entries (%u bytes)", entries.size(), offset);
+    mDirty = false;
+    return true;
+}
+
+void QMirClientStateArchive::discard()
+{
+    if (!mPath.isEmpty()) {
+        QFile::remove(mPath);
+    }
+}
@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QMIRCLIENTSTATEARCHIVE_H
+#define QMIRCLIENTSTATEARCHIVE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QMap>
+#include <QMutex>
+
+/*
+ * QMirClientStateArchive - application state surviving the process being killed while suspended.
+ *
+ * Applications hand key-value pairs to the archive whenever their state changes, which is
+ * cheap as nothing gets written until the application is about to be stopped. The archive
+ * left by a previous run is memory-mapped at startup, so that restoring state costs no more
+ * than reading the values needed, and removed right away so that it is restored at most once.
+ * Saving writes the restored values back along with the changes. The archive is discarded
+ * when the application exits normally.
+ *
+ * File format, all integers in native byte order, offsets from the start of the file:
+ *   header:  "QUSA", version, entry count, file size            (4 x 32 bits)
+ *   entries: key offset, key length, value offset, value length (4 x 32 bits each, sorted by key)
+ *   data:    keys and values, each starting on an 8 byte boundary
+ */
+class QMirClientStateArchive
+{
+public:
+    QMirClientStateArchive();
+
+    // Value from the previous run, sharing the mapped memory. Null if there is none.
+    QByteArray restoredValue(const QByteArray &key) const;
+
+    // A null value removes the key
+    void setValue(const QByteArray &key, const QByteArray &value);
+    bool save();
+    void discard();
+
+private:
+    struct Entry {
+        quint32 keyOffset;
+        quint32 keyLength;
+        quint32 valueOffset;
+        quint32 valueLength;
+    };
+
+    void map();
+    QByteArray key(const Entry &entry) const;
+    QByteArray value(const Entry &entry) const;
+
+    const QString mPath;
+    QFile mFile;
+    const uchar *mData{nullptr};
+    const Entry *mEntries{nullptr};
+    quint32 mEntryCount{0};
+
+    QMutex mMutex;
+    QMap<QByteArray, QByteArray> mChanges; // since startup
+    bool mDirty{false};
+};
+
+// Signatures of the functions exposed through QPlatformNativeInterface::nativeResourceFunctionForIntegration()
+// as "restoredstate", "setstate" and "savestate"
+typedef QByteArray (*QMirClientRestoredStateFunction)(const QByteArray &key);
+typedef void (*QMirClientSetStateFunction)(const QByteArray &key, const QByteArray &value);
+typedef bool (*QMirClientSaveStateFunction)();
+
+#endif // QMIRCLIENTSTATEARCHIVE_H
@@ -0,0 +1,133 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmirclientsuspendtrimmer.h"
+#include "qmirclientbackingstore.h"
+#include "qmirclientlogging.h"
+#include "qmirclientprocessmemory.h"
+#include "qmirclientwindow.h"
+
+#include <QGuiApplication>
+#include <QPixmapCache>
+#include <QWindow>
+
+#include <malloc.h>
+
+namespace {
+
+// Desktop windows have no Mir surface, see QMirClientClientIntegration::createPlatformWindow()
+QMirClientWindow *mirClientWindow(QWindow *window)
+{
+    return window->handle() && window->type() != Qt::Desktop ? static_cast<QMirClientWindow *>(window->handle())
+                                                              : nullptr;
+}
+
+// Estimated size of the window buffers not yet destroyed
+qint64 bufferMemory(const QWindowList &windows)
+{
+    qint64 size = 0;
+    for (QWindow *window : windows) {
+        if (QMirClientWindow *platformWindow = mirClientWindow(window)) {
+            size += platformWindow->gpuMemoryUsage();
+        }
+    }
+    return size;
+}
+
+} // anonymous namespace
+
+QMirClientSuspendTrimmer::QMirClientSuspendTrimmer()
+    : mEnabled(qEnvironmentVariableIsEmpty("QTUBUNTU_NO_SUSPEND_TRIM"))
+    , mTrimmed(false)
+{
+}
+
+void QMirClientSuspendTrimmer::trim()
+{
+    if (!mEnabled || mTrimmed) {
+        return;
+    }
+    mTrimmed = true;
+
+    const qint64 sizeBefore = qmirclientProcessMemory("VmRSS");
+
+    QMirClientBackingStore::releaseAllResources();
+
+    const QWindowList windows = QGuiApplication::allWindows();
+    const qint64 bufferMemoryBefore = bufferMemory(windows);
+    for (QWindow *window : windows) {
+        if (QMirClientWindow *platformWindow = mirClientWindow(window)) {
+            platformWindow->releaseGpuBuffers();
+        }
+    }
+
+    // QQuickWindow::releaseResources() has the render thread drop glyph caches, atlases and
+    // whatever else of its scene graph that can be rebuilt. As it makes its context current to
+    // do so, it also destroys the EGL surfaces still current that were left to it above.
+    for (QWindow *window : windows) {
+        if (window->metaObject()->indexOfSlot("releaseResources()") >= 0) {
+            QMetaObject::invokeMethod(window, "releaseResources");
+        }
+    }
+    const qint64 bufferMemoryAfter = bufferMemory(windows);
+
+    QPixmapCache::clear();
+    malloc_trim(0);
+
+    const qint64 sizeAfter = qmirclientProcessMemory("VmRSS");
+    qCDebug(mirclient, "trim() - RSS went from %lld KiB to %lld KiB, about %lld KiB of window buffers released, %lld KiB kept",
+            sizeBefore, sizeAfter, (bufferMemoryBefore - bufferMemoryAfter) / 1024, bufferMemoryAfter / 1024);
+}
+
+void QMirClientSuspendTrimmer::restore()
+{
+    if (!mTrimmed) {
+        return;
+    }
+    mTrimmed = false;
+
+    // Repaint the visible windows right away, whoever renders them recreates their EGL surface
+    for (QWindow *window : QGuiApplication::allWindows()) {
+        QMirClientWindow *platformWindow = mirClientWindow(window);
+        if (platformWindow && platformWindow->isExposed()) {
+            platformWindow->sendExposeEvent();
+        }
+    }
+}
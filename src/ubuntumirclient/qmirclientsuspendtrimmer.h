@@ -0,0 +1,70 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QMIRCLIENTSUSPENDTRIMMER_H
+#define QMIRCLIENTSUSPENDTRIMMER_H
+
+#include <QObject>
+
+/*
+ * QMirClientSuspendTrimmer - shrinks the footprint of the application while it is suspended.
+ *
+ * On suspension it, in order, releases the GL resources of the backing stores, the EGL surfaces
+ * of all windows, the scene graph resources of Qt Quick windows, then the pixmap cache, and
+ * hands the freed heap back to the system. On resumption the visible windows are repainted
+ * right away, getting their EGL surface back with their first frame. Lives in the GUI thread,
+ * trimming before the application gets stopped. Disabled by setting QTUBUNTU_NO_SUSPEND_TRIM.
+ */
+class QMirClientSuspendTrimmer : public QObject
+{
+    Q_OBJECT
+public:
+    QMirClientSuspendTrimmer();
+
+public Q_SLOTS:
+    void trim();
+    void restore();
+
+private:
+    const bool mEnabled;
+    bool mTrimmed;
+};
+
+#endif // QMIRCLIENTSUSPENDTRIMMER_H
@@ -0,0 +1,115 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmirclienttouchpoints.h"
+
+#include <QVarLengthArray>
+
+namespace {
+
+// Mir doesn't tell the pressure range of a device, while drivers of some report pressures above 1
+// (up to 1.28 on the Galaxy Nexus). Those are clamped, so that a given press always maps to the same value.
+float normalizedPressure(float pressure)
+{
+    return qBound(0.0f, pressure, 1.0f);
+}
+
+} // anonymous namespace
+
+bool QMirClientTouchPoints::update(const MirInputEvent *event, const QRect &windowGeometry)
+{
+    const MirTouchEvent *tev = mir_input_event_get_touch_event(event);
+
+    struct PreviousPoint { int id; QPointF position; qreal pressure; };
+    QVarLengthArray<PreviousPoint, 16> previousPoints;
+    for (const auto &touchPoint : mPoints) {
+        previousPoints.append(PreviousPoint{touchPoint.id, touchPoint.area.center(), touchPoint.pressure});
+    }
+
+    const int kPointerCount = static_cast<int>(mir_touch_event_point_count(tev));
+    while (mPoints.count() > kPointerCount) {
+        mPoints.removeLast();
+    }
+    while (mPoints.count() < kPointerCount) {
+        mPoints.append(QWindowSystemInterface::TouchPoint());
+    }
+
+    bool pressed = false;
+    for (int i = 0; i < kPointerCount; ++i) {
+        QWindowSystemInterface::TouchPoint &touchPoint = mPoints[i];
+
+        const float kX = mir_touch_event_axis_value(tev, i, mir_touch_axis_x) + windowGeometry.x();
+        const float kY = mir_touch_event_axis_value(tev, i, mir_touch_axis_y) + windowGeometry.y(); // see bug lp:1346633 workaround comments elsewhere
+        const float kW = mir_touch_event_axis_value(tev, i, mir_touch_axis_touch_major);
+        const float kH = mir_touch_event_axis_value(tev, i, mir_touch_axis_touch_minor);
+        const float kP = mir_touch_event_axis_value(tev, i, mir_touch_axis_pressure);
+        touchPoint.id = mir_touch_event_id(tev, i);
+        touchPoint.normalPosition = QPointF(kX / windowGeometry.width(), kY / windowGeometry.height());
+        touchPoint.area = QRectF(kX - (kW / 2.0), kY - (kH / 2.0), kW, kH);
+        touchPoint.pressure = normalizedPressure(kP);
+
+        MirTouchAction touch_action = mir_touch_event_action(tev, i);
+        switch (touch_action)
+        {
+        case mir_touch_action_down:
+            pressed = true;
+            touchPoint.state = Qt::TouchPointPressed;
+            break;
+        case mir_touch_action_up:
+            touchPoint.state = Qt::TouchPointReleased;
+            break;
+        case mir_touch_action_change:
+            touchPoint.state = Qt::TouchPointMoved;
+            for (const auto &previousPoint : previousPoints) {
+                if (previousPoint.id == touchPoint.id) {
+                    if (previousPoint.position == touchPoint.area.center()
+                            && previousPoint.pressure == touchPoint.pressure) {
+                        touchPoint.state = Qt::TouchPointStationary;
+                    }
+                    break;
+                }
+            }
+            break;
+        case mir_touch_actions:
+            Q_UNREACHABLE();
+        }
+    }
+    return pressed;
+}
@@ -41,10 +41,16 @@
 // Local
 #include "qmirclientwindow.h"
 #include "qmirclientdebugextension.h"
+#include "qmirclientflightrecorder.h"
+#include "qmirclientframeratepolicy.h"
+#include "qmirclientframetimings.h"
+#include "qmirclientgpumemorybudget.h"
 #include "qmirclientnativeinterface.h"
+#include "qmirclientperfcounters.h"
 #include "qmirclientinput.h"
 #include "qmirclientintegration.h"
 #include "qmirclientscreen.h"
+#include "qmirclientstartuptrace.h"
 #include "qmirclientlogging.h"
 
 #include <mir_toolkit/mir_client_library.h>
@@ -52,8 +58,11 @@
 
 // Qt
 #include <qpa/qwindowsysteminterface.h>
+#include <QCoreApplication>
+#include <QGuiApplication>
 #include <QMutexLocker>
 #include <QSize>
+#include <QThread>
 #include <QtMath>
 #include <QtGui/private/qguiapplication_p.h>
 #include <QtPlatformSupport/private/qeglconvenience_p.h>
@@ -66,6 +75,13 @@ namespace
 {
 const Qt::WindowType InputMethodWindowType = (Qt::WindowType)(0x00000080 | Qt::WindowType::Window); // Qt has no such thing
 const Qt::WindowType LowChromeWindowHint = (Qt::WindowType)0x00800000;
+const int streamBufferCount = 3; // Mir buffer streams are triple buffered
+
+QEvent::Type exposeEventType()
+{
+    static const auto type = static_cast<QEvent::Type>(QEvent::registerEventType());
+    return type;
+}
 
 
 struct MirSpecDeleter
@@ -359,6 +375,7 @@ MirWindow *createMirWindow(QWindow *window, int mirOutputId, QMirClientWindow *p
     }
 
     auto surface = mir_create_window_sync(spec.get());
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::CompositorRoundTrips);
     Q_ASSERT(mir_window_is_valid(surface));
     return surface;
 }
@@ -406,6 +423,15 @@ int panelHeight()
     return gridUnit * 3;
 }
 
+// Shared with the Mir callback delivering the persistent surface id, which can outlive the surface
+struct PersistentIdRequest
+{
+    QMutex mutex;
+    QMirClientWindow *window; // reset when the surface goes away
+    QString id;
+    bool answered{false};
+};
+
 } //namespace
 
 
@@ -424,7 +450,8 @@ public:
     void setSizingConstraints(const QSize& minSize, const QSize& maxSize, const QSize& increment);
     void setMask(const QRegion &mask);
 
-    void onSwapBuffersDone();
+    // Whether the buffers changed size, the frame just swapped having been rendered at the old one
+    bool onSwapBuffersDone();
     void handleSurfaceResized(int width, int height);
     int needsRepaint() const;
 
@@ -434,22 +461,36 @@ public:
     MirWindowType type() const { return mir_window_get_type(mMirWindow); }
 
     void setShellChrome(MirShellChrome shellChrome);
-
-    EGLSurface eglSurface() const { return mEglSurface; }
+    void setPointerConfinement(MirPointerConfinementState state);
+
+    // Called by the rendering thread as it makes the surface current, and once it no longer is
+    EGLSurface eglSurface();
+    void eglSurfaceDoneCurrent();
+    // Whether the rendering thread is to destroy the surface, still current, as soon as it can
+    bool eglSurfaceReleasePending() const;
+    // Called by the rendering thread with the surface current
+    void setSwapInterval(int interval);
     MirWindow *mirWindow() const { return mMirWindow; }
 
+    // Estimated size of the buffers behind the EGL surface, counted until it is destroyed
+    qint64 bufferMemory() const;
+    // Returns the memory released right away, none if the surface is current and left to the rendering thread
+    qint64 releaseEglSurface();
+
     void setSurfaceParent(MirWindow*);
     bool hasParent() const { return mParented; }
 
     QSurfaceFormat format() const { return mFormat; }
 
-    bool mNeedsExposeCatchup;
+    std::atomic<bool> mNeedsExposeCatchup;
 
     QString persistentSurfaceId();
 
 private:
     static void surfaceEventCallback(MirWindow* surface, const MirEvent *event, void* context);
+    static void persistentIdCallback(MirWindow* surface, MirWindowId *id, void* context);
     void postEvent(const MirEvent *event);
+    qint64 bufferMemoryLocked() const;
 
     QWindow * const mWindow;
     QMirClientWindow * const mPlatformWindow;
@@ -459,18 +500,26 @@ private:
 
     MirWindow* mMirWindow;
     const EGLDisplay mEglDisplay;
+    EGLConfig mEglConfig;
+
+    // Guards the EGL surface and the size of its buffers, shared by the GUI and rendering threads
+    mutable QMutex mEglSurfaceMutex;
     EGLSurface mEglSurface;
+    bool mEglSurfaceCurrent{false};
+    bool mEglSurfaceReleasePending{false};
+    int mEglSwapInterval{-1}; // last set on the surface, -1 for EGL's default
+    QSize mBufferSize;
 
     bool mNeedsRepaint;
     bool mParented;
-    QSize mBufferSize;
     QSurfaceFormat mFormat;
     MirPixelFormat mPixelFormat;
 
     QMutex mTargetSizeMutex;
     QSize mTargetSize;
     MirShellChrome mShellChrome;
-    QString mPersistentIdStr;
+    std::shared_ptr<PersistentIdRequest> mPersistentId;
+    std::shared_ptr<PersistentIdRequest> *mPersistentIdCallbackRef;
 };
 
 UbuntuSurface::UbuntuSurface(QMirClientWindow *platformWindow, EGLDisplay display, QMirClientInput *input, MirConnection *connection)
@@ -521,8 +570,17 @@ UbuntuSurface::UbuntuSurface(QMirClientWindow *platformWindow, EGLDisplay displa
     mParentWindowHandle = getParentIfNecessary(mWindow, input);
 
     mMirWindow = createMirWindow(mWindow, outputId, mParentWindowHandle, mPixelFormat, connection, surfaceEventCallback, this);
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::WindowsCreated);
+    mEglConfig = config;
     mEglSurface = eglCreateWindowSurface(mEglDisplay, config, nativeWindowFor(mMirWindow), nullptr);
 
+    // Ask for the persistent id right away, so that it's at hand by the time anyone needs it
+    // without blocking on the compositor. It gets announced with windowPropertyChanged().
+    mPersistentId = std::make_shared<PersistentIdRequest>();
+    mPersistentId->window = platformWindow;
+    mPersistentIdCallbackRef = new std::shared_ptr<PersistentIdRequest>(mPersistentId);
+    mir_window_request_window_id(mMirWindow, persistentIdCallback, mPersistentIdCallbackRef);
+
     mNeedsExposeCatchup = mir_window_get_visibility(mMirWindow) == mir_window_visibility_occluded;
 
     // Window manager can give us a final size different from what we asked for
@@ -548,11 +606,25 @@ UbuntuSurface::UbuntuSurface(QMirClientWindow *platformWindow, EGLDisplay displa
 
 UbuntuSurface::~UbuntuSurface()
 {
-    if (mEglSurface != EGL_NO_SURFACE)
-        eglDestroySurface(mEglDisplay, mEglSurface);
+    {
+        QMutexLocker lock(&mPersistentId->mutex);
+        mPersistentId->window = nullptr;
+    }
+    {
+        QMutexLocker lock(&mEglSurfaceMutex);
+        if (mEglSurface != EGL_NO_SURFACE)
+            eglDestroySurface(mEglDisplay, mEglSurface);
+    }
     if (mMirWindow) {
         mir_window_release_sync(mMirWindow);
+        QMirClientPerfCounters::increment(QMirClientPerfCounters::CompositorRoundTrips);
+        QMirClientPerfCounters::increment(QMirClientPerfCounters::WindowsDestroyed);
     }
+
+    // Replies arrive in order, so once the release round trip is done an unanswered request never will be
+    QMutexLocker lock(&mPersistentId->mutex);
+    if (!mPersistentId->answered)
+        delete mPersistentIdCallbackRef;
 }
 
 void UbuntuSurface::updateGeometry(const QRect &newGeometry)
@@ -585,6 +657,8 @@ void UbuntuSurface::updateGeometry(const QRect &newGeometry)
             (MirPlacementHints)0, 0 /* offset_dx */, 0 /* offset_dy */);
 
     mir_window_apply_spec(mMirWindow, spec.get());
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::WindowSpecsApplied);
+    QMirClientFlightRecorder::record(QMirClientFlightRecorder::WindowSpecApplied, mWindow);
 }
 
 void UbuntuSurface::updateTitle(const QString& newTitle)
@@ -593,6 +667,8 @@ void UbuntuSurface::updateTitle(const QString& newTitle)
     Spec spec{mir_create_window_spec(mConnection)};
     mir_window_spec_set_name(spec.get(), title.constData());
     mir_window_apply_spec(mMirWindow, spec.get());
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::WindowSpecsApplied);
+    QMirClientFlightRecorder::record(QMirClientFlightRecorder::WindowSpecApplied, mWindow);
 }
 
 void UbuntuSurface::setSizingConstraints(const QSize& minSize, const QSize& maxSize, const QSize& increment)
@@ -600,6 +676,8 @@ void UbuntuSurface::setSizingConstraints(const QSize& minSize, const QSize& maxS
     Spec spec{mir_create_window_spec(mConnection)};
     ::setSizingConstraints(spec.get(), minSize, maxSize, increment);
     mir_window_apply_spec(mMirWindow, spec.get());
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::WindowSpecsApplied);
+    QMirClientFlightRecorder::record(QMirClientFlightRecorder::WindowSpecApplied, mWindow);
 }
 
 void UbuntuSurface::handleSurfaceResized(int width, int height)
@@ -613,11 +691,15 @@ void UbuntuSurface::handleSurfaceResized(int width, int height)
     // The actual buffer size may or may have not changed at this point, so let the rendering
     // thread drive the window geometry updates.
     mNeedsRepaint = mTargetSize.width() == width && mTargetSize.height() == height;
+    if (!mNeedsRepaint) {
+        QMirClientPerfCounters::increment(QMirClientPerfCounters::StaleResizesDropped);
+    }
 }
 
 int UbuntuSurface::needsRepaint() const
 {
     if (mNeedsRepaint) {
+        QMutexLocker lock(&mEglSurfaceMutex);
         if (mTargetSize != mBufferSize) {
             //If the buffer hasn't changed yet, we need at least two redraws,
             //once to get the new buffer size and propagate the geometry changes
@@ -643,39 +725,150 @@ void UbuntuSurface::setShellChrome(MirShellChrome chrome)
         auto spec = Spec{mir_create_window_spec(mConnection)};
         mir_window_spec_set_shell_chrome(spec.get(), chrome);
         mir_window_apply_spec(mMirWindow, spec.get());
+        QMirClientPerfCounters::increment(QMirClientPerfCounters::WindowSpecsApplied);
+        QMirClientFlightRecorder::record(QMirClientFlightRecorder::WindowSpecApplied, mWindow);
 
         mShellChrome = chrome;
     }
 }
 
-void UbuntuSurface::onSwapBuffersDone()
+void UbuntuSurface::setPointerConfinement(MirPointerConfinementState state)
+{
+    auto spec = Spec{mir_create_window_spec(mConnection)};
+    mir_window_spec_set_pointer_confinement(spec.get(), state);
+    mir_window_apply_spec(mMirWindow, spec.get());
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::WindowSpecsApplied);
+    QMirClientFlightRecorder::record(QMirClientFlightRecorder::WindowSpecApplied, mWindow);
+}
+
+EGLSurface UbuntuSurface::eglSurface()
+{
+    QMutexLocker lock(&mEglSurfaceMutex);
+
+    // Marked current before the handle is handed out, so that the GUI thread can't destroy it meanwhile
+    mEglSurfaceCurrent = true;
+
+    // A window back in sight keeps its surface, one still hidden gets it destroyed at the next chance
+    if (mEglSurfaceReleasePending && mPlatformWindow->isExposed()) {
+        mEglSurfaceReleasePending = false;
+    }
+
+    // Released by the GPU memory budget while the window was out of sight
+    if (mEglSurface == EGL_NO_SURFACE && mEglConfig) {
+        qCDebug(mirclientGraphics, "eglSurface(window=%p) - recreating released surface", mWindow);
+        mEglSurface = eglCreateWindowSurface(mEglDisplay, mEglConfig, nativeWindowFor(mMirWindow), nullptr);
+        mEglSwapInterval = -1;
+    }
+    return mEglSurface;
+}
+
+void UbuntuSurface::eglSurfaceDoneCurrent()
+{
+    QMutexLocker lock(&mEglSurfaceMutex);
+    mEglSurfaceCurrent = false;
+
+    if (mEglSurfaceReleasePending) {
+        qCDebug(mirclientGraphics, "eglSurfaceDoneCurrent(window=%p) - releasing surface", mWindow);
+        eglDestroySurface(mEglDisplay, mEglSurface);
+        mEglSurface = EGL_NO_SURFACE;
+        mEglSurfaceReleasePending = false;
+    }
+}
+
+void UbuntuSurface::setSwapInterval(int interval)
+{
+    QMutexLocker lock(&mEglSurfaceMutex);
+    if (mEglSwapInterval == interval || mEglSurface == EGL_NO_SURFACE) {
+        return;
+    }
+
+    // EGL clamps it to the range of the config, paced no further than the driver allows
+    qCDebug(mirclientGraphics, "setSwapInterval(window=%p, interval=%d)", mWindow, interval);
+    eglSwapInterval(mEglDisplay, interval);
+    mEglSwapInterval = interval;
+}
+
+bool UbuntuSurface::eglSurfaceReleasePending() const
+{
+    QMutexLocker lock(&mEglSurfaceMutex);
+    return mEglSurfaceReleasePending;
+}
+
+qint64 UbuntuSurface::bufferMemory() const
+{
+    QMutexLocker lock(&mEglSurfaceMutex);
+    return bufferMemoryLocked();
+}
+
+// Needs mEglSurfaceMutex held
+qint64 UbuntuSurface::bufferMemoryLocked() const
+{
+    if (mEglSurface == EGL_NO_SURFACE) {
+        return 0;
+    }
+    return qint64(mBufferSize.width()) * mBufferSize.height() * MIR_BYTES_PER_PIXEL(mPixelFormat) * streamBufferCount;
+}
+
+qint64 UbuntuSurface::releaseEglSurface()
+{
+    QMutexLocker lock(&mEglSurfaceMutex);
+    const qint64 released = bufferMemoryLocked();
+    if (released == 0) {
+        return 0;
+    }
+
+    // EGL defers destroying a surface current to a context, and no new surface can be created for the
+    // Mir window until then. While current, the rendering thread destroys it at its next makeCurrent()
+    // or swap, or once it lets go of it.
+    if (mEglSurfaceCurrent) {
+        mEglSurfaceReleasePending = true;
+        return 0;
+    }
+
+    eglDestroySurface(mEglDisplay, mEglSurface);
+    mEglSurface = EGL_NO_SURFACE;
+    return released;
+}
+
+bool UbuntuSurface::onSwapBuffersDone()
 {
     static int sFrameNumber = 0;
     ++sFrameNumber;
 
     EGLint eglSurfaceWidth = -1;
     EGLint eglSurfaceHeight = -1;
-    eglQuerySurface(mEglDisplay, mEglSurface, EGL_WIDTH, &eglSurfaceWidth);
-    eglQuerySurface(mEglDisplay, mEglSurface, EGL_HEIGHT, &eglSurfaceHeight);
+    QSize previousBufferSize;
+    bool sizeChanged;
+    {
+        QMutexLocker lock(&mEglSurfaceMutex);
+        eglQuerySurface(mEglDisplay, mEglSurface, EGL_WIDTH, &eglSurfaceWidth);
+        eglQuerySurface(mEglDisplay, mEglSurface, EGL_HEIGHT, &eglSurfaceHeight);
+
+        const bool validSize = eglSurfaceWidth > 0 && eglSurfaceHeight > 0;
+        previousBufferSize = mBufferSize;
+        sizeChanged = validSize && (mBufferSize.width() != eglSurfaceWidth || mBufferSize.height() != eglSurfaceHeight);
+        if (sizeChanged) {
+            mBufferSize = QSize(eglSurfaceWidth, eglSurfaceHeight);
+        }
+    }
 
-    const bool validSize = eglSurfaceWidth > 0 && eglSurfaceHeight > 0;
+    QMirClientFlightRecorder::record(QMirClientFlightRecorder::SwapBuffersDone, mWindow, 0, eglSurfaceWidth, eglSurfaceHeight);
 
-    if (validSize && (mBufferSize.width() != eglSurfaceWidth || mBufferSize.height() != eglSurfaceHeight)) {
+    if (sizeChanged) {
 
         qCDebug(mirclientBufferSwap, "onSwapBuffersDone(window=%p) [%d] - size changed (%d, %d) => (%d, %d)",
-               mWindow, sFrameNumber, mBufferSize.width(), mBufferSize.height(), eglSurfaceWidth, eglSurfaceHeight);
-
-        mBufferSize.rwidth() = eglSurfaceWidth;
-        mBufferSize.rheight() = eglSurfaceHeight;
+               mWindow, sFrameNumber, previousBufferSize.width(), previousBufferSize.height(), eglSurfaceWidth, eglSurfaceHeight);
 
         QRect newGeometry = mPlatformWindow->geometry();
-        newGeometry.setSize(mBufferSize);
+        newGeometry.setSize(QSize(eglSurfaceWidth, eglSurfaceHeight));
 
         mPlatformWindow->QPlatformWindow::setGeometry(newGeometry);
         QWindowSystemInterface::handleGeometryChange(mWindow, newGeometry);
+        return true;
     } else {
         qCDebug(mirclientBufferSwap, "onSwapBuffersDone(window=%p) [%d] - buffer size (%d,%d)",
-               mWindow, sFrameNumber, mBufferSize.width(), mBufferSize.height());
+               mWindow, sFrameNumber, previousBufferSize.width(), previousBufferSize.height());
+        return false;
     }
 }
 
@@ -701,9 +894,13 @@ void UbuntuSurface::postEvent(const MirEvent *event)
         const auto height =  mir_resize_event_get_height(resizeEvent);
         qCDebug(mirclient, "resizeEvent(window=%p, width=%d, height=%d)", mWindow, width, height);
 
+        QMirClientFlightRecorder::record(QMirClientFlightRecorder::MirEventPosted, mWindow, eventType, width, height);
+
         QMutexLocker lock(&mTargetSizeMutex);
         mTargetSize.rwidth() = width;
         mTargetSize.rheight() = height;
+    } else {
+        QMirClientFlightRecorder::record(QMirClientFlightRecorder::MirEventPosted, mWindow, eventType);
     }
 
     mInput->postEvent(mPlatformWindow, event);
@@ -717,6 +914,8 @@ void UbuntuSurface::setSurfaceParent(MirWindow* parent)
     Spec spec{mir_create_window_spec(mConnection)};
     mir_window_spec_set_parent(spec.get(), parent);
     mir_window_apply_spec(mMirWindow, spec.get());
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::WindowSpecsApplied);
+    QMirClientFlightRecorder::record(QMirClientFlightRecorder::WindowSpecApplied, mWindow);
 }
 
 void UbuntuSurface::setMask(const QRegion &region)
@@ -726,22 +925,41 @@ void UbuntuSurface::setMask(const QRegion &region)
     Spec spec{mir_create_window_spec(mConnection)};
     ::setMask(spec.get(), region);
     mir_window_apply_spec(mMirWindow, spec.get());
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::WindowSpecsApplied);
+    QMirClientFlightRecorder::record(QMirClientFlightRecorder::WindowSpecApplied, mWindow);
 }
 
-QString UbuntuSurface::persistentSurfaceId()
+void UbuntuSurface::persistentIdCallback(MirWindow* /*surface*/, MirWindowId *id, void* context)
 {
-    if (mPersistentIdStr.isEmpty()) {
-        auto id = mir_window_request_window_id_sync(mMirWindow);
-        mPersistentIdStr = mir_window_id_as_string(id);
-        mir_window_id_release(id);
+    auto request = static_cast<std::shared_ptr<PersistentIdRequest>*>(context);
+    {
+        QMutexLocker lock(&(*request)->mutex);
+        (*request)->answered = true;
+        if (mir_window_id_is_valid(id)) {
+            (*request)->id = QString::fromLatin1(mir_window_id_as_string(id));
+            if ((*request)->window) {
+                QMetaObject::invokeMethod((*request)->window, "handlePersistentSurfaceIdReceived",
+                                          Qt::QueuedConnection);
+            }
+        } else {
+            qCWarning(mirclient, "persistentIdCallback(window=%p) - got an invalid id", (*request)->window);
+        }
     }
-    return mPersistentIdStr;
+    mir_window_id_release(id);
+    delete request;
+}
+
+QString UbuntuSurface::persistentSurfaceId()
+{
+    QMutexLocker lock(&mPersistentId->mutex);
+    return mPersistentId->id;
 }
 
 Q_DECLARE_METATYPE(QPlatformWindow*)
 
 QMirClientWindow::QMirClientWindow(QWindow *w, QMirClientInput *input, QMirClientNativeInterface *native,
-                                   QMirClientAppStateController *appState, EGLDisplay eglDisplay,
+                                   QMirClientAppStateController *appState, QMirClientGpuMemoryBudget *gpuMemoryBudget,
+                                   QMirClientFrameRatePolicy *frameRatePolicy, EGLDisplay eglDisplay,
                                    MirConnection *mirConnection, QMirClientDebugExtension *debugExt)
     : QObject(nullptr)
     , QPlatformWindow(w)
@@ -750,11 +968,21 @@ QMirClientWindow::QMirClientWindow(QWindow *w, QMirClientInput *input, QMirClien
     , mWindowFlags(w->flags())
     , mWindowVisible(false)
     , mAppStateController(appState)
+    , mGpuMemoryBudget(gpuMemoryBudget)
+    , mFrameRatePolicy(frameRatePolicy)
     , mDebugExtention(debugExt)
+    , mScreenOriginValid(false)
     , mNativeInterface(native)
     , mSurface(new UbuntuSurface{this, eglDisplay, input, mirConnection})
     , mScale(1.0)
     , mFormFactor(mir_form_factor_unknown)
+    , mFrameTimings(new QMirClientFrameTimings)
+    , mFocused(false)
+    , mFrameRateFocused(false)
+    , mRawPointer(false)
+    , mExposePosted(false)
+    , mRepaintAfterResize(false)
+    , mFrameRateOverride(-1)
 {
     static bool metaTypeRegistered = false;
     if (Q_UNLIKELY(!metaTypeRegistered)) {
@@ -768,16 +996,15 @@ QMirClientWindow::QMirClientWindow(QWindow *w, QMirClientInput *input, QMirClien
             w, w->screen()->handle(), input, mSurface.get(), qPrintable(window()->title()));
 
     updatePanelHeightHack(mSurface->state() != mir_window_state_fullscreen);
+    updateFrameRateFocus();
 
-    // queue the windowPropertyChanged signal. If it's emitted directly, the platformWindow will not yet be set for the window.
-    QMetaObject::invokeMethod(mNativeInterface, "windowPropertyChanged", Qt::QueuedConnection,
-                              Q_ARG(QPlatformWindow*, this),
-                              Q_ARG(QString, "persistentSurfaceId"));
+    mGpuMemoryBudget->addWindow(this);
 }
 
 QMirClientWindow::~QMirClientWindow()
 {
     qCDebug(mirclient, "~QMirClientWindow(window=%p)", this);
+    mGpuMemoryBudget->removeWindow(this);
 }
 
 void QMirClientWindow::handleSurfaceResized(int width, int height)
@@ -785,6 +1012,7 @@ void QMirClientWindow::handleSurfaceResized(int width, int height)
     QMutexLocker lock(&mMutex);
     qCDebug(mirclient, "handleSurfaceResize(window=%p, size=(%dx%d)px", window(), width, height);
 
+    invalidateScreenOrigin();
     mSurface->handleSurfaceResized(width, height);
 
     // This resize event could have occurred just after the last buffer swap for this window.
@@ -792,12 +1020,15 @@ void QMirClientWindow::handleSurfaceResized(int width, int height)
     // will then render at the old size. After swapping the client now will get a new buffer with the
     // updated size but it still needs re-rendering so another redraw may be needed.
     // A mir API to drop the currently held buffer would help here, so that we wouldn't have to redraw twice
+    // The second redraw is only needed once the frame at the old size is swapped, onSwapBuffersDone() asks for it.
     auto const numRepaints = mSurface->needsRepaint();
     lock.unlock();
     qCDebug(mirclient, "handleSurfaceResize(window=%p) redraw %d times", window(), numRepaints);
-    for (int i = 0; i < numRepaints; i++) {
-        qCDebug(mirclient, "handleSurfaceResize(window=%p) repainting size=(%dx%d)dp", window(), geometry().size().width(), geometry().size().height());
-        QWindowSystemInterface::handleExposeEvent(window(), QRect(QPoint(), geometry().size()));
+    if (numRepaints > 1) {
+        mRepaintAfterResize = true;
+    }
+    if (numRepaints > 0) {
+        scheduleExpose();
     }
 }
 
@@ -811,12 +1042,15 @@ void QMirClientWindow::handleSurfaceExposeChange(bool exposed)
     mWindowExposed = exposed;
 
     lock.unlock();
-    QWindowSystemInterface::handleExposeEvent(window(), QRect(QPoint(), geometry().size()));
+    scheduleExpose();
+    updateGpuMemoryBudget();
 }
 
 void QMirClientWindow::handleSurfaceFocusChanged(bool focused)
 {
     qCDebug(mirclient, "handleSurfaceFocusChanged(window=%p, focused=%d)", window(), focused);
+    mFocused = focused;
+    updateFrameRateFocus();
 
     if (focused) {
         mAppStateController->setWindowFocused(true);
@@ -839,7 +1073,8 @@ void QMirClientWindow::handleSurfaceVisibilityChanged(bool visible)
     if (mWindowVisible == visible) return;
     mWindowVisible = visible;
 
-    QWindowSystemInterface::handleExposeEvent(window(), QRect(QPoint(), geometry().size()));
+    scheduleExpose();
+    updateGpuMemoryBudget();
 }
 
 void QMirClientWindow::handleSurfaceStateChanged(Qt::WindowState state)
@@ -873,6 +1108,9 @@ void QMirClientWindow::setWindowFlags(Qt::WindowFlags flags)
     mWindowFlags = flags;
 
     mSurface->setShellChrome(mWindowFlags & LowChromeWindowHint ? mir_shell_chrome_low : mir_shell_chrome_normal);
+
+    lock.unlock();
+    updateFrameRateFocus();
 }
 
 /*
@@ -907,7 +1145,7 @@ QRect QMirClientWindow::geometry() const
 {
     if (mDebugExtention) {
         auto geom = QPlatformWindow::geometry();
-        geom.moveTopLeft(mDebugExtention->mapWindowPointToScreen(mSurface->mirWindow(), QPoint(0,0)));
+        geom.moveTopLeft(screenOrigin());
         return geom;
     } else {
         return QPlatformWindow::geometry();
@@ -929,6 +1167,7 @@ void QMirClientWindow::setGeometry(const QRect &rect)
     QRect newPosition(geometry());
     newPosition.moveTo(rect.topLeft());
     QPlatformWindow::setGeometry(newPosition);
+    invalidateScreenOrigin();
 
     mSurface->updateGeometry(rect);
     // Note: don't call handleGeometryChange here, wait to see what Mir replies with.
@@ -954,8 +1193,13 @@ void QMirClientWindow::setVisible(bool visible)
     }
 
     lock.unlock();
+    // The transient parent may have been set after creation
+    if (visible) {
+        updateFrameRateFocus();
+    }
     updateSurfaceState();
-    QWindowSystemInterface::handleExposeEvent(window(), QRect(QPoint(), geometry().size()));
+    scheduleExpose();
+    updateGpuMemoryBudget();
 }
 
 void QMirClientWindow::setWindowTitle(const QString& title)
@@ -965,6 +1209,18 @@ void QMirClientWindow::setWindowTitle(const QString& title)
     mSurface->updateTitle(title);
 }
 
+void QMirClientWindow::setRawPointer(bool enabled)
+{
+    QMutexLocker lock(&mMutex);
+    qCDebug(mirclient, "setRawPointer(window=%p, enabled=%d)", window(), enabled);
+    if (enabled == mRawPointer) {
+        return;
+    }
+    mRawPointer = enabled;
+    mSurface->setPointerConfinement(enabled ? mir_pointer_confined_to_window : mir_pointer_unconfined);
+    Q_EMIT mNativeInterface->windowPropertyChanged(this, QStringLiteral("rawPointer"));
+}
+
 void QMirClientWindow::propagateSizeHints()
 {
     QMutexLocker lock(&mMutex);
@@ -995,17 +1251,46 @@ QSurfaceFormat QMirClientWindow::format() const
 QPoint QMirClientWindow::mapToGlobal(const QPoint &pos) const
 {
     if (mDebugExtention) {
-        return mDebugExtention->mapWindowPointToScreen(mSurface->mirWindow(), pos);
+        return screenOrigin() + pos;
     } else {
         return pos;
     }
 }
 
+// The debug extension translates coordinates with a round trip to the server, and Qt asks for
+// the geometry of a window several times per frame and on every touch event. The windows only
+// move by placement, resize or window events, which invalidate the origin cached in between.
+QPoint QMirClientWindow::screenOrigin() const
+{
+    QMutexLocker lock(&mScreenOriginMutex);
+    if (!mScreenOriginValid) {
+        mScreenOrigin = mDebugExtention->mapWindowPointToScreen(mSurface->mirWindow(), QPoint(0,0));
+        mScreenOriginValid = true;
+    }
+    return mScreenOrigin;
+}
+
+void QMirClientWindow::invalidateScreenOrigin()
+{
+    QMutexLocker lock(&mScreenOriginMutex);
+    mScreenOriginValid = false;
+}
+
 void* QMirClientWindow::eglSurface() const
 {
     return mSurface->eglSurface();
 }
 
+void QMirClientWindow::eglSurfaceDoneCurrent()
+{
+    mSurface->eglSurfaceDoneCurrent();
+}
+
+bool QMirClientWindow::eglSurfaceReleasePending() const
+{
+    return mSurface->eglSurfaceReleasePending();
+}
+
 MirWindow *QMirClientWindow::mirWindow() const
 {
     return mSurface->mirWindow();
@@ -1018,20 +1303,60 @@ WId QMirClientWindow::winId() const
 
 void QMirClientWindow::onSwapBuffersDone()
 {
+    QMirClientStartupTrace::firstFrameSwapped();
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::BufferSwaps);
+
     QMutexLocker lock(&mMutex);
-    mSurface->onSwapBuffersDone();
+    if (mSurface->onSwapBuffersDone() && mRepaintAfterResize.exchange(false)) {
+        scheduleExpose();
+    }
 
     if (mSurface->mNeedsExposeCatchup) {
         mSurface->mNeedsExposeCatchup = false;
         mWindowExposed = false;
 
         lock.unlock();
-        QWindowSystemInterface::handleExposeEvent(window(), QRect(QPoint(), geometry().size()));
+        scheduleExpose();
+        // Called by the rendering thread, the budget lives in the GUI thread
+        QMetaObject::invokeMethod(this, "updateGpuMemoryBudget", Qt::QueuedConnection);
     }
 }
 
+// A single change of a window's state from Mir or Qt can ask for several expose events, each making the
+// render loops render a frame. They are coalesced into one for the whole window at its latest size, sent
+// once the events pending are processed. Safe to call from the rendering thread.
+void QMirClientWindow::scheduleExpose()
+{
+    if (!mExposePosted.exchange(true)) {
+        QCoreApplication::postEvent(this, new QEvent(exposeEventType()), Qt::LowEventPriority);
+    } else {
+        QMirClientPerfCounters::increment(QMirClientPerfCounters::ExposeEventsCoalesced);
+    }
+}
+
+void QMirClientWindow::customEvent(QEvent *event)
+{
+    if (event->type() != exposeEventType()) {
+        QObject::customEvent(event);
+        return;
+    }
+
+    mExposePosted = false;
+    sendExposeEvent();
+}
+
+void QMirClientWindow::sendExposeEvent()
+{
+    QWindowSystemInterface::handleExposeEvent(window(), QRect(QPoint(), geometry().size()));
+    QMirClientPerfCounters::increment(QMirClientPerfCounters::ExposeEventsSent);
+    QMirClientFlightRecorder::record(QMirClientFlightRecorder::ExposeSent, window(), isExposed(),
+                                     QPlatformWindow::geometry().width(), QPlatformWindow::geometry().height());
+}
+
 void QMirClientWindow::handleScreenPropertiesChange(MirFormFactor formFactor, float scale)
 {
+    invalidateScreenOrigin();
+
     // Update the scale & form factor native-interface properties for the windows affected
     // as there is no convenient way to emit signals for those custom properties on a QScreen
     if (formFactor != mFormFactor) {
@@ -1066,3 +1391,76 @@ QString QMirClientWindow::persistentSurfaceId()
 {
     return mSurface->persistentSurfaceId();
 }
+
+qint64 QMirClientWindow::gpuMemoryUsage() const
+{
+    return mSurface->bufferMemory();
+}
+
+qint64 QMirClientWindow::releaseGpuBuffers()
+{
+    qCDebug(mirclientGraphics, "releaseGpuBuffers(window=%p)", window());
+    return mSurface->releaseEglSurface();
+}
+
+qreal QMirClientWindow::frameRateCap() const
+{
+    const qreal rate = mFrameRateOverride;
+    if (rate >= 0) {
+        return rate;
+    }
+    return mFrameRatePolicy->frameRateCap(mFrameRateFocused, isExposed(), mFormFactor);
+}
+
+// Only top-level windows that lost focus get capped as unfocused. Windows that can't take focus,
+// such as popups, tooltips and child windows, and the transient children of a window treated as
+// focused go along with it.
+void QMirClientWindow::updateFrameRateFocus()
+{
+    const Qt::WindowType type = static_cast<Qt::WindowType>(int(mWindowFlags & Qt::WindowType_Mask));
+    const QMirClientWindow *parent = transientParentFor(window());
+    mFrameRateFocused = mFocused
+            || !window()->isTopLevel()
+            || type == Qt::Popup || type == Qt::ToolTip
+            || (mWindowFlags & Qt::WindowDoesNotAcceptFocus)
+            || (parent && parent->mFrameRateFocused);
+
+    for (QWindow *child : QGuiApplication::topLevelWindows()) {
+        if (child->transientParent() == window() && child->handle()) {
+            static_cast<QMirClientWindow *>(child->handle())->updateFrameRateFocus();
+        }
+    }
+}
+
+void QMirClientWindow::setFrameRateCap(qreal rate)
+{
+    qCDebug(mirclient, "setFrameRateCap(window=%p, rate=%.1f)", window(), rate);
+    mFrameRateOverride = rate;
+}
+
+void QMirClientWindow::applyFrameRateCap(int requestedSwapInterval)
+{
+    int interval = qMax(requestedSwapInterval, 0);
+
+    // The backing store and the basic render loop swap from the GUI thread, which must not be held up.
+    // Elsewhere a longer swap interval has the display pace the render loop, as it does at full rate.
+    const qreal rate = frameRateCap();
+    const QPlatformScreen *platformScreen = screen();
+    const qreal refreshRate = platformScreen ? platformScreen->refreshRate() : 0;
+    if (rate > 0 && refreshRate > rate && QThread::currentThread() != qApp->thread()) {
+        interval = qMax(interval, qCeil(refreshRate / rate - 0.01));
+    }
+    mSurface->setSwapInterval(interval);
+}
+
+void QMirClientWindow::updateGpuMemoryBudget()
+{
+    mGpuMemoryBudget->windowVisibilityChanged(this, isExposed());
+}
+
+void QMirClientWindow::handlePersistentSurfaceIdReceived()
+{
+    // Queued from the Mir callback, so the platform window is set on the window by now
+    qCDebug(mirclient, "handlePersistentSurfaceIdReceived(window=%p)", window());
+    Q_EMIT mNativeInterface->windowPropertyChanged(this, QStringLiteral("persistentSurfaceId"));
+}
@@ -48,12 +48,16 @@
 #include <mir_toolkit/common.h> // needed only for MirFormFactor enum
 #include <mir_toolkit/mir_window.h>
 
+#include <atomic>
 #include <memory>
 
 #include <EGL/egl.h>
 
 class QMirClientAppStateController;
 class QMirClientDebugExtension;
+class QMirClientFrameRatePolicy;
+class QMirClientFrameTimings;
+class QMirClientGpuMemoryBudget;
 class QMirClientNativeInterface;
 class QMirClientInput;
 class QMirClientScreen;
@@ -65,7 +69,8 @@ class QMirClientWindow : public QObject, public QPlatformWindow
     Q_OBJECT
 public:
     QMirClientWindow(QWindow *w, QMirClientInput *input, QMirClientNativeInterface *native,
-                     QMirClientAppStateController *appState, EGLDisplay eglDisplay,
+                     QMirClientAppStateController *appState, QMirClientGpuMemoryBudget *gpuMemoryBudget,
+                     QMirClientFrameRatePolicy *frameRatePolicy, EGLDisplay eglDisplay,
                      MirConnection *mirConnection, QMirClientDebugExtension *debugExt);
     virtual ~QMirClientWindow();
 
@@ -84,12 +89,18 @@ public:
     QPoint mapToGlobal(const QPoint &pos) const override;
     QSurfaceFormat format() const override;
 
+    // QObject methods.
+    void customEvent(QEvent *event) override;
+
     // Additional Window properties exposed by NativeInterface
     MirFormFactor formFactor() const { return mFormFactor; }
     float scale() const { return mScale; }
 
     // New methods.
+    // The rendering thread's EGL surface, which the GPU memory budget only destroys once no longer current
     void *eglSurface() const;
+    void eglSurfaceDoneCurrent();
+    bool eglSurfaceReleasePending() const;
     MirWindow *mirWindow() const;
     void handleSurfaceResized(int width, int height);
     void handleSurfaceExposeChange(bool exposed);
@@ -97,24 +108,61 @@ public:
     void handleSurfaceVisibilityChanged(bool visible);
     void handleSurfaceStateChanged(Qt::WindowState state);
     void onSwapBuffersDone();
+    // Exposes the whole window at its current size right away, from the GUI thread
+    void sendExposeEvent();
     void handleScreenPropertiesChange(MirFormFactor formFactor, float scale);
+    // Forgets the screen position translated by the debug extension, after the window may have moved
+    void invalidateScreenOrigin();
+    // Empty until the compositor delivered it, windowPropertyChanged() announces its arrival
     QString persistentSurfaceId();
+    QSharedPointer<QMirClientFrameTimings> frameTimings() const { return mFrameTimings; }
+    // Estimated size of the window buffers, and releasing them until the window renders again
+    qint64 gpuMemoryUsage() const;
+    qint64 releaseGpuBuffers();
+    // In Hz, 0 if not capped. The policy's unless overridden, a negative rate restoring it.
+    qreal frameRateCap() const;
+    void setFrameRateCap(qreal rate);
+    // Paces the frames to the cap with the swap interval of the EGL surface, called by the rendering
+    // thread once it is current. The GUI thread swaps at the requested interval, never being held up.
+    void applyFrameRateCap(int requestedSwapInterval);
+    // Confines the pointer to the window, which then gets its relative motion (see QMirClientInput)
+    bool rawPointer() const { return mRawPointer; }
+    void setRawPointer(bool enabled);
+
+private Q_SLOTS:
+    void handlePersistentSurfaceIdReceived();
+    void updateGpuMemoryBudget();
 
 private:
     void updatePanelHeightHack(bool enable);
+    void updateFrameRateFocus();
     void updateSurfaceState();
+    QPoint screenOrigin() const;
+    void scheduleExpose();
     mutable QMutex mMutex;
     const WId mId;
     Qt::WindowState mWindowState;
     Qt::WindowFlags mWindowFlags;
-    bool mWindowVisible;
-    bool mWindowExposed;
+    std::atomic<bool> mWindowVisible; // with mWindowExposed and mFormFactor, read by the rendering thread
+    std::atomic<bool> mWindowExposed;
     QMirClientAppStateController *mAppStateController;
+    QMirClientGpuMemoryBudget *mGpuMemoryBudget;
+    QMirClientFrameRatePolicy *mFrameRatePolicy;
     QMirClientDebugExtension *mDebugExtention;
+    mutable QMutex mScreenOriginMutex; // separate from mMutex, geometry() being called with it held
+    mutable QPoint mScreenOrigin;
+    mutable bool mScreenOriginValid;
     QMirClientNativeInterface *mNativeInterface;
     std::unique_ptr<UbuntuSurface> mSurface;
     float mScale;
-    MirFormFactor mFormFactor;
+    std::atomic<MirFormFactor> mFormFactor;
+    const QSharedPointer<QMirClientFrameTimings> mFrameTimings;
+    std::atomic<bool> mFocused;
+    std::atomic<bool> mFrameRateFocused; // what the frame rate policy is told, see updateFrameRateFocus()
+    bool mRawPointer;
+    std::atomic<bool> mExposePosted;
+    std::atomic<bool> mRepaintAfterResize;
+    std::atomic<double> mFrameRateOverride;
 };
 
 #endif // QMIRCLIENTWINDOW_H
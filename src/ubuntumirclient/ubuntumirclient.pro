@@ -12,7 +12,7 @@ QMAKE_CXXFLAGS += -fvisibility=hidden -fvisibility-inlines-hidden -std=c++11 -We
 QMAKE_LFLAGS += -std=c++11 -Wl,-no-undefined
 
 CONFIG += link_pkgconfig
-PKGCONFIG += egl mirclient ubuntu-platform-api xkbcommon libcontent-hub
+PKGCONFIG += egl mirclient ubuntu-platform-api xkbcommon libcontent-hub fontconfig
 
 SOURCES = \
     qmirclientbackingstore.cpp \
@@ -29,7 +29,20 @@ SOURCES = \
     qmirclientscreen.cpp \
     qmirclientscreenobserver.cpp \
     qmirclientwindow.cpp \
-    qmirclientappstatecontroller.cpp
+    qmirclientappstatecontroller.cpp \
+    qmirclientprogrambinarycache.cpp \
+    qmirclientframetimings.cpp \
+    qmirclientstartuptrace.cpp \
+    qmirclientperfcounters.cpp \
+    qmirclientflightrecorder.cpp \
+    qmirclientgpumemorybudget.cpp \
+    qmirclientsuspendtrimmer.cpp \
+    qmirclientstatearchive.cpp \
+    qmirclientframeratepolicy.cpp \
+    qmirclientkeysym.cpp \
+    qmirclienttouchpoints.cpp \
+    qmirclientnativeresources.cpp \
+    qmirclientprocessmemory.cpp
 
 HEADERS = \
     qmirclientbackingstore.h \
@@ -49,6 +62,19 @@ HEADERS = \
     qmirclientwindow.h \
     qmirclientlogging.h \
     qmirclientappstatecontroller.h \
+    qmirclientprogrambinarycache.h \
+    qmirclientframetimings.h \
+    qmirclientstartuptrace.h \
+    qmirclientperfcounters.h \
+    qmirclientflightrecorder.h \
+    qmirclientgpumemorybudget.h \
+    qmirclientsuspendtrimmer.h \
+    qmirclientstatearchive.h \
+    qmirclientframeratepolicy.h \
+    qmirclientkeysym.h \
+    qmirclienttouchpoints.h \
+    qmirclientextensions.h \
+    qmirclientprocessmemory.h \
     ../shared/ubuntutheme.h
 
 OTHER_FILES += \
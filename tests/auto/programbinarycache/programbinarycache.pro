@@ -0,0 +1,11 @@
+TARGET = tst_programbinarycache
+QT += gui
+
+include(../../shared/shared.pri)
+
+SOURCES = \
+    tst_programbinarycache.cpp \
+    ../../../src/ubuntumirclient/qmirclientprogrambinarycache.cpp
+
+HEADERS = \
+    ../../../src/ubuntumirclient/qmirclientprogrambinarycache.h
@@ -0,0 +1,266 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmirclientprogrambinarycache.h"
+#include "headlessplatform.h"
+
+#include <QDir>
+#include <QFile>
+#include <QGuiApplication>
+#include <QLoggingCategory>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QScopedPointer>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest>
+
+Q_LOGGING_CATEGORY(mirclientGraphics, "qt.qpa.mirclient.graphics", QtWarningMsg)
+
+namespace {
+
+const char vertexShader[] =
+    "attribute vec4 position;\n"
+    "void main() { gl_Position = position; }\n";
+
+const char whiteShader[] = "void main() { gl_FragColor = vec4(1.0); }\n";
+const char blackShader[] = "void main() { gl_FragColor = vec4(0.0, 0.0, 0.0, 1.0); }\n";
+
+} // anonymous namespace
+
+class tst_ProgramBinaryCache : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void missThenHit();
+    void leavesNoGlError();
+    void otherSourcesMiss();
+    void corruptBinaryDiscarded();
+    void disabled_data();
+    void disabled();
+
+private:
+    // Loads the program through the cache, linking and saving it on a miss
+    GLuint createProgram(QMirClientProgramBinaryCache &cache, const char *fragmentShader, bool *loaded);
+    bool isLinked(GLuint program);
+    QStringList cachedFiles() const;
+
+    QScopedPointer<QTemporaryDir> mCacheHome;
+    QOffscreenSurface mSurface;
+    QOpenGLContext mContext;
+    QOpenGLFunctions *mFunctions{nullptr};
+};
+
+void tst_ProgramBinaryCache::initTestCase()
+{
+    mSurface.create();
+    if (!mContext.create() || !mContext.makeCurrent(&mSurface)) {
+        QSKIP("No OpenGL context available");
+    }
+    mFunctions = mContext.functions();
+
+    init();
+    QMirClientProgramBinaryCache cache;
+    bool loaded;
+    mFunctions->glDeleteProgram(createProgram(cache, whiteShader, &loaded));
+    if (cachedFiles().isEmpty()) {
+        QSKIP("The driver has no program binary format");
+    }
+    cleanup();
+}
+
+void tst_ProgramBinaryCache::init()
+{
+    mCacheHome.reset(new QTemporaryDir);
+    QVERIFY(mCacheHome->isValid());
+    qputenv("XDG_CACHE_HOME", QFile::encodeName(mCacheHome->path()));
+}
+
+void tst_ProgramBinaryCache::cleanup()
+{
+    qunsetenv("QTUBUNTU_NO_PROGRAM_BINARY_CACHE");
+    qunsetenv("QTUBUNTU_PROGRAM_BINARY_CACHE_SIZE");
+    mCacheHome.reset();
+}
+
+GLuint tst_ProgramBinaryCache::createProgram(QMirClientProgramBinaryCache &cache, const char *fragmentShader, bool *loaded)
+{
+    const QByteArray sources = QByteArray(vertexShader) + fragmentShader;
+    GLuint program = mFunctions->glCreateProgram();
+    *loaded = cache.load(program, sources);
+    if (*loaded) {
+        return program;
+    }
+
+    const char *shaderSources[] = { vertexShader, fragmentShader };
+    const GLenum shaderTypes[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+    for (int i = 0; i < 2; ++i) {
+        GLuint shader = mFunctions->glCreateShader(shaderTypes[i]);
+        mFunctions->glShaderSource(shader, 1, &shaderSources[i], nullptr);
+        mFunctions->glCompileShader(shader);
+        mFunctions->glAttachShader(program, shader);
+        mFunctions->glDeleteShader(shader);
+    }
+    mFunctions->glLinkProgram(program);
+    if (isLinked(program)) {
+        cache.save(program, sources);
+    }
+    return program;
+}
+
+bool tst_ProgramBinaryCache::isLinked(GLuint program)
+{
+    GLint linked = GL_FALSE;
+    mFunctions->glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    return linked == GL_TRUE;
+}
+
+QStringList tst_ProgramBinaryCache::cachedFiles() const
+{
+    const QString directory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+            + QStringLiteral("/qtubuntu/programbinaries");
+    QStringList files;
+    for (const QString &file : QDir(directory).entryList(QDir::Files)) {
+        files.append(directory + QLatin1Char('/') + file);
+    }
+    return files;
+}
+
+void tst_ProgramBinaryCache::missThenHit()
+{
+    bool loaded;
+    {
+        QMirClientProgramBinaryCache cache;
+        GLuint program = createProgram(cache, whiteShader, &loaded);
+        QVERIFY(!loaded);
+        QVERIFY(isLinked(program));
+        mFunctions->glDeleteProgram(program);
+    }
+    QCOMPARE(cachedFiles().count(), 1);
+
+    // As on the next run of the application
+    QMirClientProgramBinaryCache cache;
+    GLuint program = createProgram(cache, whiteShader, &loaded);
+    QVERIFY(loaded);
+    QVERIFY(isLinked(program));
+    mFunctions->glDeleteProgram(program);
+}
+
+void tst_ProgramBinaryCache::leavesNoGlError()
+{
+    while (mFunctions->glGetError() != GL_NO_ERROR) {}
+
+    QMirClientProgramBinaryCache cache;
+    bool loaded;
+    mFunctions->glDeleteProgram(createProgram(cache, whiteShader, &loaded));
+    mFunctions->glDeleteProgram(createProgram(cache, whiteShader, &loaded));
+    QCOMPARE(mFunctions->glGetError(), GLenum(GL_NO_ERROR));
+}
+
+void tst_ProgramBinaryCache::otherSourcesMiss()
+{
+    QMirClientProgramBinaryCache cache;
+    bool loaded;
+    mFunctions->glDeleteProgram(createProgram(cache, whiteShader, &loaded));
+    mFunctions->glDeleteProgram(createProgram(cache, blackShader, &loaded));
+    QVERIFY(!loaded);
+    QCOMPARE(cachedFiles().count(), 2);
+}
+
+void tst_ProgramBinaryCache::corruptBinaryDiscarded()
+{
+    QMirClientProgramBinaryCache cache;
+    bool loaded;
+    mFunctions->glDeleteProgram(createProgram(cache, whiteShader, &loaded));
+    QCOMPARE(cachedFiles().count(), 1);
+
+    QFile file(cachedFiles().first());
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray contents = file.readAll();
+    contents[contents.size() / 2] = ~contents.at(contents.size() / 2);
+    file.seek(0);
+    file.write(contents);
+    file.close();
+
+    GLuint program = mFunctions->glCreateProgram();
+    QVERIFY(!cache.load(program, QByteArray(vertexShader) + whiteShader));
+    QVERIFY(cachedFiles().isEmpty());
+    mFunctions->glDeleteProgram(program);
+}
+
+void tst_ProgramBinaryCache::disabled_data()
+{
+    QTest::addColumn<QByteArray>("variable");
+    QTest::addColumn<QByteArray>("value");
+
+    QTest::newRow("no cache") << QByteArray("QTUBUNTU_NO_PROGRAM_BINARY_CACHE") << QByteArray("1");
+    QTest::newRow("zero size") << QByteArray("QTUBUNTU_PROGRAM_BINARY_CACHE_SIZE") << QByteArray("0");
+}
+
+void tst_ProgramBinaryCache::disabled()
+{
+    QFETCH(QByteArray, variable);
+    QFETCH(QByteArray, value);
+    qputenv(variable.constData(), value);
+
+    QMirClientProgramBinaryCache cache;
+    QVERIFY(!cache.isEnabled());
+    bool loaded;
+    mFunctions->glDeleteProgram(createProgram(cache, whiteShader, &loaded));
+    mFunctions->glDeleteProgram(createProgram(cache, whiteShader, &loaded));
+    QVERIFY(!loaded);
+    QVERIFY(cachedFiles().isEmpty());
+}
+
+int main(int argc, char *argv[])
+{
+    useHeadlessPlatform();
+    QGuiApplication app(argc, argv);
+    tst_ProgramBinaryCache test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_programbinarycache.moc"
@@ -0,0 +1,7 @@
+TARGET = tst_bench_backingstore
+QT += gui
+
+include(../benchmark.pri)
+
+SOURCES = \
+    tst_bench_backingstore.cpp
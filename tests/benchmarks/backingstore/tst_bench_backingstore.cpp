@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "allocationcounter.h"
+#include "headlessplatform.h"
+
+#include <QBackingStore>
+#include <QGuiApplication>
+#include <QScopedPointer>
+#include <QWindow>
+#include <QtTest>
+
+// QMirClientBackingStore, shared by the headless plugin, uploading the painted region of a window
+// to its texture and drawing it
+class tst_BackingStore : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void flush_data();
+    void flush();
+
+private:
+    QScopedPointer<QWindow> mWindow;
+    QScopedPointer<QBackingStore> mBackingStore;
+};
+
+void tst_BackingStore::initTestCase()
+{
+    mWindow.reset(new QWindow);
+    mWindow->resize(1280, 800);
+    mBackingStore.reset(new QBackingStore(mWindow.data()));
+    mWindow->show();
+    QVERIFY(QTest::qWaitForWindowExposed(mWindow.data()));
+    mBackingStore->resize(mWindow->size());
+
+    // Creates the texture
+    mBackingStore->beginPaint(QRect(QPoint(), mWindow->size()));
+    mBackingStore->endPaint();
+    mBackingStore->flush(QRect(QPoint(), mWindow->size()));
+}
+
+void tst_BackingStore::cleanupTestCase()
+{
+    mBackingStore.reset();
+    mWindow.reset();
+}
+
+void tst_BackingStore::flush_data()
+{
+    QTest::addColumn<QRegion>("region");
+
+    QTest::newRow("whole window") << QRegion(0, 0, 1280, 800);
+    QTest::newRow("full width band") << QRegion(0, 300, 1280, 40);
+    QTest::newRow("wide rect") << QRegion(100, 300, 800, 40);
+    QTest::newRow("text cursor") << QRegion(640, 400, 2, 20);
+
+    QRegion icons;
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            icons |= QRect(100 + column * 200, 100 + row * 150, 48, 48);
+        }
+    }
+    QTest::newRow("16 icons") << icons;
+}
+
+void tst_BackingStore::flush()
+{
+    QFETCH(QRegion, region);
+
+    QBENCHMARK {
+        mBackingStore->beginPaint(region);
+        mBackingStore->endPaint();
+        mBackingStore->flush(region);
+    }
+
+    reportAllocations([&]() {
+        mBackingStore->beginPaint(region);
+        mBackingStore->endPaint();
+        mBackingStore->flush(region);
+    });
+}
+
+int main(int argc, char *argv[])
+{
+    useHeadlessPlatform();
+    // Not throttled to a display's rate
+    qputenv("QTUBUNTU_HEADLESS_FRAME_RATE", "0");
+    QGuiApplication app(argc, argv);
+    tst_BackingStore test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_bench_backingstore.moc"
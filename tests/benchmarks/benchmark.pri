@@ -0,0 +1,9 @@
+# Benchmarks run with "make benchmark" rather than "make check", and report the heap allocations
+# of each operation along with its time
+include(../shared/shared.pri)
+CONFIG += benchmark
+
+INCLUDEPATH += $$PWD
+
+HEADERS += $$PWD/allocationcounter.h
+SOURCES += $$PWD/allocationcounter.cpp
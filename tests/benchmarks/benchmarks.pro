@@ -0,0 +1,8 @@
+TEMPLATE = subdirs
+SUBDIRS += \
+    keysym \
+    touchpoints \
+    backingstore \
+    gmenumodelexporter \
+    nativeresources \
+    startup
@@ -0,0 +1,27 @@
+TARGET = tst_bench_gmenumodelexporter
+QT += gui-private dbus
+
+include(../benchmark.pri)
+
+CONFIG += link_pkgconfig no_keywords
+PKGCONFIG += gio-2.0
+
+APPMENU = ../../../src/ubuntuappmenu
+INCLUDEPATH += $$APPMENU
+
+DBUS_INTERFACES += $$APPMENU/com.ubuntu.MenuRegistrar.xml
+
+SOURCES = \
+    tst_bench_gmenumodelexporter.cpp \
+    $$APPMENU/gmenumodelexporter.cpp \
+    $$APPMENU/gmenumodelplatformmenu.cpp \
+    $$APPMENU/menuregistrar.cpp \
+    $$APPMENU/registry.cpp \
+    $$APPMENU/qtubuntuextraactionhandler.cpp
+
+HEADERS += \
+    $$APPMENU/gmenumodelexporter.h \
+    $$APPMENU/gmenumodelplatformmenu.h \
+    $$APPMENU/menuregistrar.h \
+    $$APPMENU/registry.h \
+    $$APPMENU/qtubuntuextraactionhandler.h
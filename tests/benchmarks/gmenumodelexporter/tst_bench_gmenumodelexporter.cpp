@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "gmenumodelexporter.h"
+#include "gmenumodelplatformmenu.h"
+#include "allocationcounter.h"
+#include "headlessplatform.h"
+
+#include <QGuiApplication>
+#include <QKeySequence>
+#include <QLoggingCategory>
+#include <QScopedPointer>
+#include <QtTest>
+
+// Defined by the theme plugin, which is not linked in
+Q_LOGGING_CATEGORY(ubuntuappmenu, "ubuntuappmenu", QtWarningMsg)
+
+namespace {
+
+// A menu bar sized menu of submenus, their items in sections of 10 with a few checkable ones and
+// shortcuts. Everything is a child of the returned menu.
+UbuntuPlatformMenu *createMenu(int submenuCount, int itemCount)
+{
+    auto menu = new UbuntuPlatformMenu;
+    for (int i = 0; i < submenuCount; ++i) {
+        auto submenu = new UbuntuPlatformMenu;
+        submenu->setParent(menu);
+        submenu->setText(QStringLiteral("Menu %1").arg(i));
+
+        for (int j = 0; j < itemCount; ++j) {
+            auto item = new UbuntuPlatformMenuItem;
+            item->setParent(menu);
+            if (j % 10 == 9) {
+                item->setIsSeparator(true);
+            } else {
+                item->setText(QStringLiteral("Item %1.%2").arg(i).arg(j));
+                item->setCheckable(j % 10 == 0);
+                item->setShortcut(QKeySequence(Qt::CTRL + Qt::Key_A + j % 26));
+            }
+            submenu->insertMenuItem(item, nullptr);
+        }
+
+        auto submenuItem = new UbuntuPlatformMenuItem;
+        submenuItem->setParent(menu);
+        submenuItem->setMenu(submenu);
+        menu->insertMenuItem(submenuItem, nullptr);
+    }
+    return menu;
+}
+
+} // anonymous namespace
+
+// Building the GMenu model of a menu, as happens whenever its structure changes
+class tst_GMenuModelExporter : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void exportMenu_data();
+    void exportMenu();
+};
+
+void tst_GMenuModelExporter::initTestCase()
+{
+    // Every exporter complains about never having been put on the session bus
+    QLoggingCategory::setFilterRules(QStringLiteral("ubuntuappmenu.warning=false"));
+}
+
+void tst_GMenuModelExporter::exportMenu_data()
+{
+    QTest::addColumn<int>("submenuCount");
+    QTest::addColumn<int>("itemCount");
+
+    QTest::newRow("1 menu of 10 items") << 1 << 10;
+    QTest::newRow("1 menu of 1000 items") << 1 << 1000;
+    QTest::newRow("10 menus of 100 items") << 10 << 100;
+}
+
+void tst_GMenuModelExporter::exportMenu()
+{
+    QFETCH(int, submenuCount);
+    QFETCH(int, itemCount);
+    QScopedPointer<UbuntuPlatformMenu> menu(createMenu(submenuCount, itemCount));
+
+    QBENCHMARK {
+        UbuntuMenuExporter exporter(menu.data());
+    }
+
+    reportAllocations([&]() {
+        UbuntuMenuExporter exporter(menu.data());
+    });
+}
+
+int main(int argc, char *argv[])
+{
+    useHeadlessPlatform();
+    QGuiApplication app(argc, argv);
+    tst_GMenuModelExporter test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_bench_gmenumodelexporter.moc"
@@ -0,0 +1,14 @@
+TARGET = tst_bench_keysym
+QT -= gui
+
+include(../benchmark.pri)
+
+CONFIG += link_pkgconfig
+PKGCONFIG += xkbcommon
+
+SOURCES = \
+    tst_bench_keysym.cpp \
+    ../../../src/ubuntumirclient/qmirclientkeysym.cpp
+
+HEADERS += \
+    ../../../src/ubuntumirclient/qmirclientkeysym.h
@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmirclientkeysym.h"
+#include "allocationcounter.h"
+
+#include <QtTest>
+
+#include <xkbcommon/xkbcommon-keysyms.h>
+
+// What QMirClientInput::dispatchKeyEvent() makes of a keysym before handing the key over to Qt
+class tst_Keysym : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void translate_data();
+    void translate();
+    void keyEvent_data();
+    void keyEvent();
+};
+
+void tst_Keysym::translate_data()
+{
+    QTest::addColumn<uint>("keysym");
+
+    QTest::newRow("letter") << uint(XKB_KEY_a);
+    QTest::newRow("digit") << uint(XKB_KEY_5);
+    QTest::newRow("accented letter") << uint(XKB_KEY_eacute);
+    QTest::newRow("cyrillic letter") << uint(XKB_KEY_Cyrillic_a);
+    QTest::newRow("function key") << uint(XKB_KEY_F5);
+    QTest::newRow("return") << uint(XKB_KEY_Return);
+    QTest::newRow("arrow") << uint(XKB_KEY_Left);
+    QTest::newRow("dead key") << uint(XKB_KEY_dead_acute);
+    QTest::newRow("volume key") << uint(XKB_KEY_XF86AudioRaiseVolume);
+}
+
+void tst_Keysym::translate()
+{
+    QFETCH(uint, keysym);
+    const QString text = qmirclientKeysymText(keysym);
+
+    uint32_t key = 0;
+    QBENCHMARK {
+        key = qmirclientTranslateKeysym(keysym, text);
+    }
+    Q_UNUSED(key);
+
+    reportAllocations([&]() { qmirclientTranslateKeysym(keysym, text); });
+}
+
+void tst_Keysym::keyEvent_data()
+{
+    translate_data();
+}
+
+// The text along with the key
+void tst_Keysym::keyEvent()
+{
+    QFETCH(uint, keysym);
+
+    uint32_t key = 0;
+    QBENCHMARK {
+        const QString text = qmirclientKeysymText(keysym);
+        key = qmirclientTranslateKeysym(keysym, text);
+    }
+    Q_UNUSED(key);
+
+    reportAllocations([&]() { qmirclientTranslateKeysym(keysym, qmirclientKeysymText(keysym)); });
+}
+
+QTEST_GUILESS_MAIN(tst_Keysym)
+
+#include "tst_bench_keysym.moc"
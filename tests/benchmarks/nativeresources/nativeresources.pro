@@ -0,0 +1,12 @@
+TARGET = tst_bench_nativeresources
+QT += gui-private
+
+include(../benchmark.pri)
+
+CONFIG += link_pkgconfig no_keywords
+PKGCONFIG += egl mirclient ubuntu-platform-api
+DEFINES += MESA_EGL_NO_X11_HEADERS
+
+SOURCES = \
+    tst_bench_nativeresources.cpp \
+    ../../../src/ubuntumirclient/qmirclientnativeresources.cpp
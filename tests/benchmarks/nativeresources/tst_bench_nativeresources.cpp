@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmirclientnativeinterface.h"
+#include "allocationcounter.h"
+
+#include <QtTest>
+
+// The name lookup every QMirClientNativeInterface resource query starts with, some of them made
+// once a frame
+class tst_NativeResources : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void lookup_data();
+    void lookup();
+};
+
+void tst_NativeResources::lookup_data()
+{
+    QTest::addColumn<QByteArray>("resource");
+    QTest::addColumn<bool>("known");
+
+    QTest::newRow("first") << QByteArray("egldisplay") << true;
+    QTest::newRow("last") << QByteArray("savestate") << true;
+    QTest::newRow("mixed case") << QByteArray("EglContext") << true;
+    QTest::newRow("unknown") << QByteArray("nosuchresource") << false;
+}
+
+void tst_NativeResources::lookup()
+{
+    QFETCH(QByteArray, resource);
+    QFETCH(bool, known);
+
+    QMirClientNativeInterface::ResourceType type;
+    bool found = false;
+    QBENCHMARK {
+        found = QMirClientNativeInterface::lookupResource(resource, &type);
+    }
+    QCOMPARE(found, known);
+
+    reportAllocations([&]() { QMirClientNativeInterface::lookupResource(resource, &type); });
+}
+
+QTEST_GUILESS_MAIN(tst_NativeResources)
+
+#include "tst_bench_nativeresources.moc"
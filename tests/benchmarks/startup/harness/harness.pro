@@ -0,0 +1,11 @@
+TARGET = tst_bench_startup
+QT -= gui
+
+include(../../../shared/shared.pri)
+CONFIG += benchmark
+
+DEFINES += STARTUP_QML_SCENE=\\\"$$PWD/../startup.qml\\\"
+DEFINES += STARTUP_WIDGETS_APP=\\\"$$shadowed($$PWD/../widgets)/startup-widgets\\\"
+
+SOURCES = \
+    tst_bench_startup.cpp
@@ -0,0 +1,244 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "headlessplatform.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include <algorithm>
+
+namespace {
+
+// Runs of each workload, of which the median is reported
+const int kRuns = 3;
+// Milliseconds to wait for the first frame of a run
+const int kFirstFrameTimeout = 60000;
+
+struct StartupSummary
+{
+    qreal timeToFirstFrame; // milliseconds
+    qint64 peakRss;         // bytes
+    qint64 compositorRoundTrips;
+};
+
+qreal median(QVector<qreal> values)
+{
+    std::sort(values.begin(), values.end());
+    return values.at(values.count() / 2);
+}
+
+} // anonymous namespace
+
+/*
+ * Startup of a QML and a QWidget application, as summarized by the plugin's startup trace
+ * (QTUBUNTU_STARTUP_TRACE) once the first frame got swapped: time from process start, peak RSS
+ * by then and the blocking compositor round trips made.
+ *
+ * Runs under the headless "ubuntu" plugin of the tree, which makes no compositor round trips. Set
+ * QT_QPA_PLATFORM=ubuntumirclient to measure against a Mir server instead, such as a session or
+ * tools/qtubuntu-headless-mir. Run with "-o file,xml" for results to track over time.
+ */
+class tst_Startup : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void timeToFirstFrame_data();
+    void timeToFirstFrame();
+    void peakRss_data();
+    void peakRss();
+    void compositorRoundTrips_data();
+    void compositorRoundTrips();
+
+private:
+    void workloads();
+    // Measured on first use, shared by the three benchmarks
+    const StartupSummary *summary(const QString &workload, const QStringList &command);
+    bool runOnce(const QStringList &command, StartupSummary *summary);
+
+    QHash<QString, StartupSummary> mSummaries;
+};
+
+void tst_Startup::initTestCase()
+{
+    // The workloads inherit the environment
+    useHeadlessPlatform();
+
+    const QByteArray platform = qgetenv("QT_QPA_PLATFORM");
+    if (platform != "ubuntu" && platform != "ubuntumirclient") {
+        QSKIP("Only the ubuntu and ubuntumirclient platforms write a startup trace");
+    }
+}
+
+void tst_Startup::workloads()
+{
+    QTest::addColumn<QStringList>("command");
+
+    const QString qmlscene = QStandardPaths::findExecutable(QStringLiteral("qmlscene"));
+    if (!qmlscene.isEmpty()) {
+        QTest::newRow("qml") << QStringList{qmlscene, QStringLiteral(STARTUP_QML_SCENE)};
+    } else {
+        qWarning("qmlscene not found, skipping the QML workload");
+    }
+    QTest::newRow("widgets") << QStringList{QStringLiteral(STARTUP_WIDGETS_APP)};
+}
+
+const StartupSummary *tst_Startup::summary(const QString &workload, const QStringList &command)
+{
+    auto it = mSummaries.constFind(workload);
+    if (it != mSummaries.constEnd()) {
+        return &it.value();
+    }
+
+    QVector<qreal> timesToFirstFrame, peakRss, roundTrips;
+    for (int run = 0; run < kRuns; ++run) {
+        StartupSummary result;
+        if (!runOnce(command, &result)) {
+            return nullptr;
+        }
+        timesToFirstFrame.append(result.timeToFirstFrame);
+        peakRss.append(result.peakRss);
+        roundTrips.append(result.compositorRoundTrips);
+    }
+
+    const StartupSummary result{median(timesToFirstFrame), qint64(median(peakRss)), qint64(median(roundTrips))};
+    return &mSummaries.insert(workload, result).value();
+}
+
+bool tst_Startup::runOnce(const QStringList &command, StartupSummary *summary)
+{
+    QTemporaryDir directory;
+    const QString tracePath = directory.path() + QStringLiteral("/trace.json");
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert(QStringLiteral("QTUBUNTU_STARTUP_TRACE"), tracePath);
+    QProcess process;
+    process.setProcessEnvironment(environment);
+    process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    process.start(command.first(), command.mid(1));
+    if (!process.waitForStarted()) {
+        qWarning("Failed to start %s", qPrintable(command.first()));
+        return false;
+    }
+
+    // The trace gets written once the first frame is swapped, the application keeps running
+    QJsonObject trace;
+    QElapsedTimer timer;
+    timer.start();
+    while (trace.isEmpty() && process.state() == QProcess::Running && timer.elapsed() < kFirstFrameTimeout) {
+        QFile file(tracePath);
+        if (file.open(QIODevice::ReadOnly)) {
+            trace = QJsonDocument::fromJson(file.readAll()).object().value(QStringLiteral("otherData")).toObject();
+        }
+        if (trace.isEmpty()) {
+            QTest::qWait(20);
+        }
+    }
+    process.kill();
+    process.waitForFinished();
+
+    const qreal timeToFirstFrame = trace.value(QStringLiteral("timeToFirstFrame")).toDouble(-1);
+    if (timeToFirstFrame < 0) {
+        qWarning("%s swapped no frame", qPrintable(command.join(QLatin1Char(' '))));
+        return false;
+    }
+    if (!trace.value(QStringLiteral("measuredFromProcessStart")).toBool()) {
+        qWarning("Process start time unavailable, measured from the plugin load instead");
+    }
+
+    summary->timeToFirstFrame = timeToFirstFrame / 1000;
+    summary->peakRss = qint64(trace.value(QStringLiteral("peakRssKb")).toDouble()) * 1024;
+    summary->compositorRoundTrips = qint64(trace.value(QStringLiteral("compositorRoundTrips")).toDouble());
+    return true;
+}
+
+void tst_Startup::timeToFirstFrame_data()
+{
+    workloads();
+}
+
+void tst_Startup::timeToFirstFrame()
+{
+    QFETCH(QStringList, command);
+    const StartupSummary *result = summary(QString::fromLatin1(QTest::currentDataTag()), command);
+    QVERIFY(result);
+    QTest::setBenchmarkResult(result->timeToFirstFrame, QTest::WalltimeMilliseconds);
+}
+
+void tst_Startup::peakRss_data()
+{
+    workloads();
+}
+
+void tst_Startup::peakRss()
+{
+    QFETCH(QStringList, command);
+    const StartupSummary *result = summary(QString::fromLatin1(QTest::currentDataTag()), command);
+    QVERIFY(result);
+    QTest::setBenchmarkResult(result->peakRss, QTest::BytesAllocated);
+}
+
+void tst_Startup::compositorRoundTrips_data()
+{
+    workloads();
+}
+
+void tst_Startup::compositorRoundTrips()
+{
+    QFETCH(QStringList, command);
+    const StartupSummary *result = summary(QString::fromLatin1(QTest::currentDataTag()), command);
+    QVERIFY(result);
+    QTest::setBenchmarkResult(result->compositorRoundTrips, QTest::Events);
+}
+
+QTEST_GUILESS_MAIN(tst_Startup)
+
+#include "tst_bench_startup.moc"
@@ -0,0 +1,6 @@
+TEMPLATE = subdirs
+SUBDIRS += \
+    widgets \
+    harness
+
+harness.depends = widgets
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ */
+
+// A small but representative scene for the startup benchmark: text,
+// images, a list view and some animations, so that fonts, shaders and textures
+// all get set up before the first frame.
+
+import QtQuick 2.4
+
+Rectangle {
+    width: 540
+    height: 960
+    color: "#f7f7f7"
+
+    ListView {
+        anchors.fill: parent
+        model: 50
+        delegate: Rectangle {
+            width: parent.width
+            height: 80
+            color: index % 2 ? "white" : "#eeeeee"
+
+            Rectangle {
+                id: avatar
+                anchors { left: parent.left; leftMargin: 16; verticalCenter: parent.verticalCenter }
+                width: 48
+                height: 48
+                radius: 24
+                gradient: Gradient {
+                    GradientStop { position: 0; color: Qt.hsla(index / 50, 0.6, 0.6, 1) }
+                    GradientStop { position: 1; color: Qt.hsla(index / 50, 0.6, 0.4, 1) }
+                }
+                RotationAnimation on rotation { from: 0; to: 360; duration: 4000; loops: Animation.Infinite }
+            }
+
+            Column {
+                anchors { left: avatar.right; leftMargin: 16; verticalCenter: parent.verticalCenter }
+                Text { text: "Item " + index; font.pixelSize: 20; font.bold: true }
+                Text { text: "Some secondary text for item " + index; font.pixelSize: 14; color: "#666666" }
+            }
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+// A small but representative widget window for the startup benchmark: menus, a tool bar, a form
+// and a populated table, so that styles, fonts and the backing store all get set up before the
+// first frame.
+
+#include <QApplication>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QFormLayout>
+#include <QLineEdit>
+#include <QMainWindow>
+#include <QMenuBar>
+#include <QSplitter>
+#include <QStatusBar>
+#include <QTableWidget>
+#include <QToolBar>
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    QMainWindow window;
+    window.resize(540, 960);
+
+    for (const char *title : { "&File", "&Edit", "&View", "&Help" }) {
+        QMenu *menu = window.menuBar()->addMenu(QString::fromLatin1(title));
+        for (int i = 0; i < 8; ++i) {
+            menu->addAction(QStringLiteral("Action %1").arg(i));
+        }
+    }
+
+    QToolBar *toolBar = window.addToolBar(QStringLiteral("Tools"));
+    for (const char *action : { "New", "Open", "Save", "Undo", "Redo" }) {
+        toolBar->addAction(QString::fromLatin1(action));
+    }
+
+    auto form = new QWidget;
+    auto formLayout = new QFormLayout(form);
+    formLayout->addRow(QStringLiteral("Name"), new QLineEdit(QStringLiteral("Some text")));
+    formLayout->addRow(QStringLiteral("Address"), new QLineEdit);
+    auto comboBox = new QComboBox;
+    comboBox->addItems({ QStringLiteral("First"), QStringLiteral("Second"), QStringLiteral("Third") });
+    formLayout->addRow(QStringLiteral("Choice"), comboBox);
+    formLayout->addRow(new QCheckBox(QStringLiteral("An option")));
+
+    auto table = new QTableWidget(200, 3);
+    for (int row = 0; row < table->rowCount(); ++row) {
+        table->setItem(row, 0, new QTableWidgetItem(QStringLiteral("Item %1").arg(row)));
+        table->setItem(row, 1, new QTableWidgetItem(QStringLiteral("Some secondary text for item %1").arg(row)));
+        table->setItem(row, 2, new QTableWidgetItem(QString::number(row * 17 % 101)));
+    }
+
+    auto splitter = new QSplitter(Qt::Vertical);
+    splitter->addWidget(form);
+    splitter->addWidget(table);
+    window.setCentralWidget(splitter);
+    window.statusBar()->showMessage(QStringLiteral("Ready"));
+
+    window.show();
+    return app.exec();
+}
@@ -0,0 +1,9 @@
+# Workload of the startup benchmark, not installed. Built by "make benchmark" like the harness.
+TARGET = startup-widgets
+TEMPLATE = app
+QT += widgets
+CONFIG -= app_bundle
+CONFIG += testcase_targets
+QMAKE_CXXFLAGS += -std=c++11 -Werror -Wall
+
+SOURCES = main.cpp
@@ -0,0 +1,14 @@
+TARGET = tst_bench_touchpoints
+QT += gui-private
+
+include(../benchmark.pri)
+
+CONFIG += link_pkgconfig
+PKGCONFIG += mirclient mircommon
+
+SOURCES = \
+    tst_bench_touchpoints.cpp \
+    ../../../src/ubuntumirclient/qmirclienttouchpoints.cpp
+
+HEADERS += \
+    ../../../src/ubuntumirclient/qmirclienttouchpoints.h
@@ -0,0 +1,112 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Canonical, Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmirclienttouchpoints.h"
+#include "allocationcounter.h"
+
+#include <QtTest>
+
+#include <mir/events/event_builders.h>
+
+#include <vector>
+
+namespace {
+
+// Fingers in a row, shifted by the given offset
+mir::EventUPtr touchEvent(int pointCount, float offset)
+{
+    auto event = mir::events::make_event(MirInputDeviceId(1), std::chrono::nanoseconds(0),
+                                         std::vector<uint8_t>(), mir_input_event_modifier_none);
+    for (int i = 0; i < pointCount; ++i) {
+        mir::events::add_touch(*event, i, mir_touch_action_change, mir_touch_tooltype_finger,
+                               100 + 50 * i + offset, 200 + offset, 0.5f, 8, 8, 8);
+    }
+    return event;
+}
+
+} // anonymous namespace
+
+// The touch points QMirClientInput::dispatchTouchEvent() hands over to Qt for each Mir touch event
+class tst_TouchPoints : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void update_data();
+    void update();
+};
+
+void tst_TouchPoints::update_data()
+{
+    QTest::addColumn<int>("pointCount");
+    QTest::addColumn<int>("nextPointCount");
+    QTest::addColumn<bool>("moving");
+
+    QTest::newRow("1 point moving") << 1 << 1 << true;
+    QTest::newRow("1 point stationary") << 1 << 1 << false;
+    QTest::newRow("5 points moving") << 5 << 5 << true;
+    QTest::newRow("10 points moving") << 10 << 10 << true;
+    QTest::newRow("finger added and lifted") << 2 << 3 << true;
+}
+
+// Alternates between two events, as a drag would
+void tst_TouchPoints::update()
+{
+    QFETCH(int, pointCount);
+    QFETCH(int, nextPointCount);
+    QFETCH(bool, moving);
+
+    const mir::EventUPtr events[] = { touchEvent(pointCount, 0), touchEvent(nextPointCount, moving ? 1 : 0) };
+    const QRect windowGeometry(0, 0, 1080, 1920);
+    QMirClientTouchPoints touchPoints;
+    int next = 0;
+
+    QBENCHMARK {
+        touchPoints.update(mir_event_get_input_event(events[next++ % 2].get()), windowGeometry);
+    }
+
+    reportAllocations([&]() {
+        touchPoints.update(mir_event_get_input_event(events[next++ % 2].get()), windowGeometry);
+    });
+}
+
+QTEST_GUILESS_MAIN(tst_TouchPoints)
+
+#include "tst_bench_touchpoints.moc"
@@ -0,0 +1,9 @@
+# Tests render with Mesa's software rasterizer through the headless "ubuntu" plugin built in the tree
+QT += testlib
+CONFIG += testcase no_testcase_installs c++11
+QMAKE_CXXFLAGS += -std=c++11 -Werror -Wall
+
+INCLUDEPATH += $$PWD $$PWD/../../src/ubuntumirclient
+DEFINES += QTUBUNTU_HEADLESS_PLUGIN_DIR=\\\"$$shadowed($$PWD/../../src/platforms/ubuntu/ubuntucommon)\\\"
+
+HEADERS += $$PWD/headlessplatform.h